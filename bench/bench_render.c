@@ -0,0 +1,654 @@
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/player/frame.h>
+#include <yeetee/player/sixel.h>
+#include <yeetee/player/cells.h>
+#include <yeetee/player/pages.h>
+#include <yeetee/player/hist.h>
+#include <yeetee/player/output.h>
+#include <yeetee/player/remote.h>
+
+#define BENCH_ITERS 200
+#define BENCH_WARMUP 10
+#define BENCH_PAGES_W 1920
+#define BENCH_PAGES_H 1080
+#define BENCH_PIPE_FRAMES 300
+#define BENCH_PIPE_SLOTS 3
+#define BENCH_PIPE_BOX 128
+#define BENCH_PIPE_DRAIN_MAX 65536
+#define BENCH_PIPE_ESC_MAX 320
+#define BENCH_PIPE_SHM_NAME_B64 "eXQtYmVuY2g="
+
+typedef struct bench_res
+{
+    uint32_t w;
+    uint32_t h;
+} bench_res_t;
+
+typedef enum bench_path
+{
+    BENCH_PATH_SHM = 0,
+    BENCH_PATH_ZLIB
+} bench_path_t;
+
+typedef struct bench_drain
+{
+    pthread_t thread;
+    uint32_t fd;
+    uint64_t bytes;
+} bench_drain_t;
+
+typedef struct bench_pipe
+{
+    uint64_t wall_ns;
+    uint64_t bytes;
+    uint64_t sent;
+    yt_hist_t render;
+    yt_hist_t stage;
+    yt_hist_t e2e;
+} bench_pipe_t;
+
+static uint8_t bench_sink_pipe = 1;
+
+static const bench_res_t bench_resolutions[] = {
+    { 640, 360 },
+    { 1280, 720 },
+    { 1920, 1080 },
+};
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts = LDG_STRUCT_ZERO_INIT;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * LDG_NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+// alpha fixup vs native packed rgb; per-frame cost of the post-process pass and the bytes kitty has to read
+static void bench_alpha(void)
+{
+    yt_frame_alpha_kernel_t kernels[YT_FRAME_ALPHA_KERNEL_MAX];
+    uint32_t kernel_cunt = yt_frame_alpha_kernels_get(kernels, YT_FRAME_ALPHA_KERNEL_MAX);
+
+    fprintf(stdout, "alpha pass (dispatch: %s)\n", yt_frame_alpha_impl_get());
+    fprintf(stdout, "%-10s %-8s %14s %14s %10s\n", "res", "path", "bytes/frame", "ns/frame", "GB/s");
+
+    uint32_t r = 0;
+    for (; r < sizeof(bench_resolutions) / sizeof(bench_resolutions[0]); r++)
+    {
+        const bench_res_t *res = &bench_resolutions[r];
+        size_t rgba_size = (size_t)res->w * res->h * yt_frame_fmt_bpp_get(YT_FRAME_FMT_RGBA32);
+        size_t rgb_size = (size_t)res->w * res->h * yt_frame_fmt_bpp_get(YT_FRAME_FMT_RGB24);
+
+        uint8_t *buff = (uint8_t *)malloc(rgba_size);
+        if (LDG_UNLIKELY(!buff)) { return; }
+
+        memset(buff, 0x5A, rgba_size);
+
+        char res_str[16] = LDG_ARR_ZERO_INIT;
+        snprintf(res_str, sizeof(res_str), "%ux%u", res->w, res->h);
+
+        uint32_t k = 0;
+        for (; k < kernel_cunt; k++)
+        {
+            uint32_t i = 0;
+            for (; i < BENCH_WARMUP; i++) { kernels[k].fn(buff, rgba_size); }
+
+            uint64_t start = bench_now_ns();
+            for (i = 0; i < BENCH_ITERS; i++) { kernels[k].fn(buff, rgba_size); }
+
+            uint64_t per_frame = (bench_now_ns() - start) / BENCH_ITERS;
+            double gbps = per_frame ? (double)rgba_size / (double)per_frame : 0.0;
+
+            fprintf(stdout, "%-10s %-8s %14zu %14lu %10.2f\n", res_str, kernels[k].name, rgba_size, (unsigned long)per_frame, gbps);
+        }
+
+        fprintf(stdout, "%-10s %-8s %14zu %14d %10s\n", res_str, "rgb24", rgb_size, 0, "-");
+
+        free(buff);
+    }
+}
+
+// tile hash cost per frame; what the dedup / delta check adds before anything is sent
+static void bench_tiles(void)
+{
+    fprintf(stdout, "\ntile hash (%upx tiles, dispatch: %s)\n", YT_FRAME_TILE_PX, yt_frame_hash_impl_get());
+    fprintf(stdout, "%-10s %-8s %14s %14s %10s\n", "res", "fmt", "tiles", "ns/frame", "GB/s");
+
+    uint32_t r = 0;
+    for (; r < sizeof(bench_resolutions) / sizeof(bench_resolutions[0]); r++)
+    {
+        const bench_res_t *res = &bench_resolutions[r];
+        uint32_t tile_max = YT_FRAME_TILES(res->w) * YT_FRAME_TILES(res->h);
+
+        uint64_t *hashes = (uint64_t *)calloc(tile_max, sizeof(uint64_t));
+        if (LDG_UNLIKELY(!hashes)) { return; }
+
+        char res_str[16] = LDG_ARR_ZERO_INIT;
+        snprintf(res_str, sizeof(res_str), "%ux%u", res->w, res->h);
+
+        yt_frame_fmt_t fmts[2] = { YT_FRAME_FMT_RGB24, YT_FRAME_FMT_RGBA32 };
+        uint32_t f = 0;
+        for (; f < 2; f++)
+        {
+            uint32_t bpp = yt_frame_fmt_bpp_get(fmts[f]);
+            size_t stride = (size_t)res->w * bpp;
+            size_t size = stride * res->h;
+
+            uint8_t *buff = (uint8_t *)malloc(size);
+            if (LDG_UNLIKELY(!buff)) { free(hashes); return; }
+
+            memset(buff, 0x5A, size);
+
+            uint32_t i = 0;
+            for (; i < BENCH_WARMUP; i++) { yt_frame_tiles_hash(buff, res->w, res->h, stride, bpp, hashes, tile_max); }
+
+            uint64_t start = bench_now_ns();
+            for (i = 0; i < BENCH_ITERS; i++) { yt_frame_tiles_hash(buff, res->w, res->h, stride, bpp, hashes, tile_max); }
+
+            uint64_t per_frame = (bench_now_ns() - start) / BENCH_ITERS;
+            double gbps = per_frame ? (double)size / (double)per_frame : 0.0;
+
+            fprintf(stdout, "%-10s %-8s %14u %14lu %10.2f\n", res_str, yt_frame_fmt_name_get(fmts[f]), tile_max, (unsigned long)per_frame, gbps);
+
+            free(buff);
+        }
+
+        free(hashes);
+    }
+}
+
+// gradient shifted per frame so every cell and most sixel columns change; the worst case for both encoders
+static void bench_text_fill(uint8_t *buff, uint32_t w, uint32_t h, uint32_t phase)
+{
+    uint32_t y = 0;
+    for (; y < h; y++)
+    {
+        uint8_t *row = buff + (size_t)y * w * 4;
+        uint32_t x = 0;
+        for (; x < w; x++)
+        {
+            row[x * 4 + 0] = (uint8_t)(x + phase);
+            row[x * 4 + 1] = (uint8_t)(y * 2 + phase);
+            row[x * 4 + 2] = (uint8_t)((x ^ y) + phase);
+            row[x * 4 + 3] = 0;
+        }
+    }
+}
+
+static void bench_text(void)
+{
+    fprintf(stdout, "\ntext backends (full-frame change, quant: %s)\n", yt_frame_quant_impl_get());
+    fprintf(stdout, "%-10s %-8s %14s %14s %10s\n", "res", "backend", "ns/frame", "bytes/frame", "fps");
+
+    uint32_t r = 0;
+    for (; r < sizeof(bench_resolutions) / sizeof(bench_resolutions[0]); r++)
+    {
+        const bench_res_t *res = &bench_resolutions[r];
+        size_t stride = (size_t)res->w * 4;
+
+        uint8_t *frames[2] = { (uint8_t *)malloc(stride * res->h), (uint8_t *)malloc(stride * res->h) };
+        if (LDG_UNLIKELY(!frames[0] || !frames[1])) { free(frames[0]); free(frames[1]); return; }
+
+        bench_text_fill(frames[0], res->w, res->h, 0);
+        bench_text_fill(frames[1], res->w, res->h, 16);
+
+        char res_str[16] = LDG_ARR_ZERO_INIT;
+        snprintf(res_str, sizeof(res_str), "%ux%u", res->w, res->h);
+
+        // sixel draws the surface pixel for pixel
+        yt_sixel_t sixel;
+        memset(&sixel, 0, sizeof(sixel));
+        size_t bytes = 0;
+        uint32_t i = 0;
+        for (; i < BENCH_WARMUP; i++) { yt_sixel_encode(&sixel, frames[i & 1], res->w, stride, 0, res->h); }
+
+        uint64_t start = bench_now_ns();
+        for (i = 0; i < BENCH_ITERS; i++)
+        {
+            yt_sixel_encode(&sixel, frames[i & 1], res->w, stride, 0, res->h);
+            bytes += sixel.out_len;
+        }
+
+        uint64_t per_frame = (bench_now_ns() - start) / BENCH_ITERS;
+        fprintf(stdout, "%-10s %-8s %14lu %14lu %10.1f\n", res_str, "sixel", (unsigned long)per_frame, (unsigned long)(bytes / BENCH_ITERS), per_frame ? 1e9 / (double)per_frame : 0.0);
+        yt_sixel_free(&sixel);
+
+        // cells; one cell per 8 px column and two 8 px rows, roughly the grid a terminal of this pixel size shows
+        uint32_t cols = res->w / 8;
+        uint32_t rows = res->h / 16;
+        yt_cells_t cells;
+        memset(&cells, 0, sizeof(cells));
+        bytes = 0;
+        for (i = 0; i < BENCH_WARMUP; i++) { yt_cells_encode(&cells, frames[i & 1], cols, rows * 2, stride, 0, rows, 0, 0); }
+
+        start = bench_now_ns();
+        for (i = 0; i < BENCH_ITERS; i++)
+        {
+            yt_cells_encode(&cells, frames[i & 1], cols, rows * 2, stride, 0, rows, 0, 0);
+            bytes += cells.out_len;
+        }
+
+        per_frame = (bench_now_ns() - start) / BENCH_ITERS;
+        fprintf(stdout, "%-10s %-8s %14lu %14lu %10.1f\n", res_str, "cells", (unsigned long)per_frame, (unsigned long)(bytes / BENCH_ITERS), per_frame ? 1e9 / (double)per_frame : 0.0);
+        yt_cells_free(&cells);
+
+        free(frames[0]);
+        free(frames[1]);
+    }
+}
+
+// one 1080p rgba slot per page size; first touch is the fault cost a fresh ring pays, the pass is what every frame pays
+static void bench_pages_run(const char *name, uint8_t *buff, size_t frame_size, uint64_t *hashes, uint32_t tile_max)
+{
+    uint32_t w = BENCH_PAGES_W;
+    uint32_t h = BENCH_PAGES_H;
+    size_t stride = (size_t)w * 4;
+
+    uint64_t start = bench_now_ns();
+    memset(buff, 0, frame_size);
+    uint64_t touch_ns = bench_now_ns() - start;
+
+    // mpv's write, the alpha pass and the tile hash; the three full-frame sweeps on the render thread
+    uint32_t i = 0;
+    for (; i < BENCH_WARMUP; i++) { memset(buff, (int)i, frame_size); yt_frame_alpha_fill(buff, frame_size); yt_frame_tiles_hash(buff, w, h, stride, 4, hashes, tile_max); }
+
+    start = bench_now_ns();
+    for (i = 0; i < BENCH_ITERS; i++)
+    {
+        memset(buff, (int)i, frame_size);
+        yt_frame_alpha_fill(buff, frame_size);
+        yt_frame_tiles_hash(buff, w, h, stride, 4, hashes, tile_max);
+    }
+
+    uint64_t per_frame = (bench_now_ns() - start) / BENCH_ITERS;
+    fprintf(stdout, "%-10s %-8s %14lu %14lu %10.2f\n", "1920x1080", name, (unsigned long)touch_ns, (unsigned long)per_frame, per_frame ? (double)frame_size * 3 / (double)per_frame : 0.0);
+}
+
+static void bench_pages(void)
+{
+    fprintf(stdout, "\nframe pages (write + alpha + hash)\n");
+    fprintf(stdout, "%-10s %-8s %14s %14s %10s\n", "res", "pages", "touch ns", "ns/frame", "GB/s");
+
+    size_t frame_size = (size_t)BENCH_PAGES_W * BENCH_PAGES_H * 4;
+    size_t size = yt_pages_huge_round(frame_size);
+    uint32_t tile_max = YT_FRAME_TILES(BENCH_PAGES_W) * YT_FRAME_TILES(BENCH_PAGES_H);
+
+    uint64_t *hashes = (uint64_t *)calloc(tile_max, sizeof(uint64_t));
+    if (LDG_UNLIKELY(!hashes)) { return; }
+
+    // small pages, with the advice switched off so a thp=always host still measures 4k
+    void *map = mmap(0x0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map != MAP_FAILED)
+    {
+        madvise(map, size, MADV_NOHUGEPAGE);
+        bench_pages_run(yt_pages_kind_name_get(YT_PAGES_KIND_SMALL), (uint8_t *)map, frame_size, hashes, tile_max);
+        munmap(map, size);
+    }
+
+    // huge-page aligned so the kernel can use a pmd for every 2 MiB of the frame
+    map = mmap(0x0, size + YT_PAGES_HUGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map != MAP_FAILED)
+    {
+        uint8_t *aligned = (uint8_t *)(((uintptr_t)map + YT_PAGES_HUGE_SIZE - 1) & ~(uintptr_t)(YT_PAGES_HUGE_SIZE - 1));
+        yt_pages_kind_t kind = yt_pages_advise(aligned, size, 0);
+        bench_pages_run(yt_pages_kind_name_get(kind), aligned, frame_size, hashes, tile_max);
+        munmap(map, size + YT_PAGES_HUGE_SIZE);
+    }
+
+    uint32_t fd = 0;
+    map = MAP_FAILED;
+    if (yt_pages_hugetlb_open(size, &fd) == LDG_ERR_AOK)
+    {
+        map = mmap(0x0, size, PROT_READ | PROT_WRITE, MAP_SHARED, (int)fd, 0);
+        close((int)fd);
+    }
+
+    if (map != MAP_FAILED)
+    {
+        bench_pages_run(yt_pages_kind_name_get(YT_PAGES_KIND_HUGETLB), (uint8_t *)map, frame_size, hashes, tile_max);
+        munmap(map, size);
+    }
+    else { fprintf(stdout, "%-10s %-8s %14s %14s %10s\n", "1920x1080", "hugetlb", "-", "no pool", "-"); }
+
+    free(hashes);
+}
+
+// odd widths; padded rows keep every row start on a cache line for the quantizer's vector loads
+static void bench_stride(void)
+{
+    fprintf(stdout, "\nquant stride (dispatch: %s)\n", yt_frame_quant_impl_get());
+    fprintf(stdout, "%-10s %-8s %14s %14s %10s\n", "res", "stride", "bytes/row", "ns/frame", "GB/s");
+
+    static const bench_res_t odd[] = { { 1366, 768 }, { 1678, 1010 } };
+
+    uint32_t r = 0;
+    for (; r < sizeof(odd) / sizeof(odd[0]); r++)
+    {
+        const bench_res_t *res = &odd[r];
+        size_t strides[2] = { (size_t)res->w * 4, yt_pages_stride_align((size_t)res->w * 4) };
+        const char *names[2] = { "tight", "aligned" };
+
+        char res_str[16] = LDG_ARR_ZERO_INIT;
+        snprintf(res_str, sizeof(res_str), "%ux%u", res->w, res->h);
+
+        uint8_t *dst = (uint8_t *)malloc((size_t)res->w * res->h);
+        if (LDG_UNLIKELY(!dst)) { return; }
+
+        uint32_t s = 0;
+        for (; s < 2; s++)
+        {
+            uint8_t *src = (uint8_t *)aligned_alloc(YT_PAGES_STRIDE_ALIGN, yt_pages_stride_align(strides[s] * res->h));
+            if (LDG_UNLIKELY(!src)) { free(dst); return; }
+
+            memset(src, 0x5A, strides[s] * res->h);
+
+            uint32_t i = 0;
+            for (; i < BENCH_WARMUP; i++) { yt_frame_quant(src, res->w, res->h, strides[s], 0, dst); }
+
+            uint64_t start = bench_now_ns();
+            for (i = 0; i < BENCH_ITERS; i++) { yt_frame_quant(src, res->w, res->h, strides[s], 0, dst); }
+
+            uint64_t per_frame = (bench_now_ns() - start) / BENCH_ITERS;
+            size_t bytes = (size_t)res->w * 4 * res->h;
+            fprintf(stdout, "%-10s %-8s %14zu %14lu %10.2f\n", res_str, names[s], strides[s], (unsigned long)per_frame, per_frame ? (double)bytes / (double)per_frame : 0.0);
+
+            free(src);
+        }
+
+        free(dst);
+    }
+}
+
+// static gradient with a box sliding across it; mpv writes every byte of every frame, only the box is damage
+static void bench_pipe_fill(uint8_t *buff, uint32_t w, uint32_t h, size_t stride, uint32_t bpp, uint32_t phase)
+{
+    uint32_t box_x = (phase * 8) % (w > BENCH_PIPE_BOX ? w - BENCH_PIPE_BOX : 1);
+    uint32_t box_y = h / 2 > BENCH_PIPE_BOX / 2 ? h / 2 - BENCH_PIPE_BOX / 2 : 0;
+
+    uint32_t y = 0;
+    for (; y < h; y++)
+    {
+        uint8_t *row = buff + (size_t)y * stride;
+        uint8_t in_y = (y >= box_y && y < box_y + BENCH_PIPE_BOX);
+        uint32_t x = 0;
+        for (; x < w; x++)
+        {
+            uint8_t *px = row + (size_t)x * bpp;
+            uint8_t in_box = in_y && x >= box_x && x < box_x + BENCH_PIPE_BOX;
+            px[0] = in_box ? 0xFF : (uint8_t)x;
+            px[1] = in_box ? 0x20 : (uint8_t)y;
+            px[2] = in_box ? 0x20 : (uint8_t)(x + y);
+            if (bpp == 4) { px[3] = 0; }
+        }
+    }
+}
+
+static void* bench_drain_loop(void *arg)
+{
+    bench_drain_t *drain = (bench_drain_t *)arg;
+    char buff[BENCH_PIPE_DRAIN_MAX];
+
+    for (;;)
+    {
+        ssize_t rd = read((int)drain->fd, buff, sizeof(buff));
+        if (rd > 0)
+        {
+            drain->bytes += (uint64_t)rd;
+            continue;
+        }
+
+        if (rd < 0 && errno == EINTR) { continue; }
+
+        break;
+    }
+
+    return 0x0;
+}
+
+// the render thread's half of a frame; writes, alpha, hash and the band, then hands off to the chosen path
+static uint32_t bench_pipe_run(const bench_res_t *res, yt_frame_fmt_t fmt, bench_path_t path, bench_pipe_t *out)
+{
+    uint32_t bpp = yt_frame_fmt_bpp_get(fmt);
+    size_t stride = (size_t)res->w * bpp;
+    size_t frame_size = stride * res->h;
+    uint32_t tile_max = YT_FRAME_TILES(res->w) * YT_FRAME_TILES(res->h);
+
+    uint8_t *slots[BENCH_PIPE_SLOTS] = LDG_ARR_ZERO_INIT;
+    uint64_t *hashes[2] = { (uint64_t *)calloc(tile_max, sizeof(uint64_t)), (uint64_t *)calloc(tile_max, sizeof(uint64_t)) };
+    uint32_t ret = LDG_ERR_AOK;
+
+    uint32_t s = 0;
+    for (; s < BENCH_PIPE_SLOTS; s++) { slots[s] = (uint8_t *)aligned_alloc(YT_PAGES_STRIDE_ALIGN, yt_pages_stride_align(frame_size)); }
+
+    for (s = 0; s < BENCH_PIPE_SLOTS; s++) { if (LDG_UNLIKELY(!slots[s])) { ret = LDG_ERR_ALLOC_NULL; } }
+
+    if (LDG_UNLIKELY(!hashes[0] || !hashes[1])) { ret = LDG_ERR_ALLOC_NULL; }
+
+    int pipe_fds[2] = { -1, -1 };
+    int sink_fd = -1;
+    if (ret == LDG_ERR_AOK)
+    {
+        if (bench_sink_pipe && pipe(pipe_fds) == 0) { sink_fd = pipe_fds[1]; }
+        else if (!bench_sink_pipe) { sink_fd = open("/dev/null", O_WRONLY | O_CLOEXEC); }
+
+        if (LDG_UNLIKELY(sink_fd < 0)) { ret = LDG_ERR_IO_OPEN; }
+    }
+
+    if (ret != LDG_ERR_AOK)
+    {
+        for (s = 0; s < BENCH_PIPE_SLOTS; s++) { free(slots[s]); }
+
+        free(hashes[0]);
+        free(hashes[1]);
+        return ret;
+    }
+
+    // the writer thread only knows stdout; the sink stands in for the terminal while the report fd is parked
+    fflush(stdout);
+    int report_fd = dup(STDOUT_FILENO);
+    dup2(sink_fd, STDOUT_FILENO);
+    close(sink_fd);
+
+    bench_drain_t drain = LDG_STRUCT_ZERO_INIT;
+    uint8_t drain_on = 0;
+    if (bench_sink_pipe)
+    {
+        drain.fd = (uint32_t)pipe_fds[0];
+        drain_on = (pthread_create(&drain.thread, 0x0, bench_drain_loop, &drain) == 0);
+    }
+
+    memset(out, 0, sizeof(*out));
+    yt_hist_reset(&out->render);
+    yt_hist_reset(&out->stage);
+    yt_hist_reset(&out->e2e);
+
+    yt_output_t output;
+    yt_remote_t remote;
+    uint8_t remote_on = 0;
+    ret = yt_output_init(&output);
+    if (ret == LDG_ERR_AOK && path == BENCH_PATH_ZLIB)
+    {
+        ret = yt_remote_init(&remote, &output);
+        remote_on = (ret == LDG_ERR_AOK);
+    }
+
+    uint32_t inuse = 0;
+    uint32_t tile_cur = 0;
+    uint64_t posted_bytes = 0;
+    uint64_t start = bench_now_ns();
+    uint32_t i = 0;
+    for (; ret == LDG_ERR_AOK && i < BENCH_PIPE_FRAMES; i++)
+    {
+        s = i % BENCH_PIPE_SLOTS;
+
+        // a slot still held by the stage is waited out; the renderer would have skipped to another
+        while (remote_on && (inuse & (1u << s)))
+        {
+            inuse &= ~yt_remote_done_take(&remote);
+            if (inuse & (1u << s)) { usleep(50); }
+        }
+
+        uint64_t origin = bench_now_ns();
+        bench_pipe_fill(slots[s], res->w, res->h, stride, bpp, i);
+        if (fmt == YT_FRAME_FMT_RGBA32) { yt_frame_alpha_fill(slots[s], frame_size); }
+
+        uint32_t next = 1 - tile_cur;
+        uint32_t tile_cunt = yt_frame_tiles_hash(slots[s], res->w, res->h, stride, bpp, hashes[next], tile_max);
+        uint32_t dirty_rows = res->h;
+        uint32_t dirty_y = (i == 0) ? 0 : yt_frame_tiles_band(hashes[tile_cur], hashes[next], tile_cunt, res->w, res->h, &dirty_rows);
+        if (dirty_y == YT_FRAME_BAND_NONE) { dirty_y = 0; }
+        tile_cur = next;
+
+        uint64_t rendered = bench_now_ns();
+        yt_hist_record(&out->render, rendered - origin);
+
+        if (path == BENCH_PATH_SHM)
+        {
+            // only the escape crosses the pipe; kitty reads the pixels out of the shm file
+            char esc[BENCH_PIPE_ESC_MAX];
+            int esc_len = yt_frame_kitty_band_esc(esc, sizeof(esc), fmt, res->w, stride, dirty_y, dirty_rows, 1, BENCH_PIPE_SHM_NAME_B64);
+            if (LDG_UNLIKELY(esc_len < 0 || esc_len >= (int)sizeof(esc))) { ret = LDG_ERR_OVERFLOW; break; }
+
+            struct iovec iov[1] = { { esc, (size_t)esc_len } };
+            yt_output_video_wait(&output);
+            ret = yt_output_video_post(&output, iov, 1);
+            posted_bytes += (uint64_t)esc_len;
+
+            uint64_t posted = bench_now_ns();
+            yt_hist_record(&out->stage, posted - rendered);
+            yt_hist_record(&out->e2e, posted - origin);
+            out->sent++;
+            continue;
+        }
+
+        yt_remote_job_t job = LDG_STRUCT_ZERO_INIT;
+        job.pixels = slots[s];
+        job.stride = stride;
+        job.fmt = fmt;
+        job.slot = s;
+        job.kitty_id = 1 + (i & 1);
+        job.pixel_w = res->w;
+        job.pixel_h = res->h;
+        job.dirty_y = dirty_y;
+        job.dirty_rows = dirty_rows;
+        job.place_cols = res->w / 8;
+        job.place_rows = res->h / 16;
+        job.origin_ns = origin;
+        job.delta = (i != 0 && dirty_rows != 0 && dirty_rows < res->h);
+
+        // the slot is the stage's only once the post lands, or the drain below waits on it forever
+        ret = yt_remote_post(&remote, &job);
+        if (ret == LDG_ERR_AOK) { inuse |= 1u << s; }
+    }
+
+    // everything posted reaches the sink before the clock stops
+    if (remote_on)
+    {
+        while (inuse != 0)
+        {
+            inuse &= ~yt_remote_done_take(&remote);
+            if (inuse != 0) { usleep(50); }
+        }
+
+        yt_remote_hist_get(&remote, &out->stage, &out->e2e);
+        out->sent = out->e2e.cunt;
+        posted_bytes = yt_remote_stats_take(&remote, 0x0);
+        yt_remote_shutdown(&remote);
+    }
+
+    yt_output_shutdown(&output);
+
+    // restoring stdout drops the last write end; the drain sees eof once the pipe is empty
+    fflush(stdout);
+    dup2(report_fd, STDOUT_FILENO);
+    close(report_fd);
+
+    if (drain_on) { pthread_join(drain.thread, 0x0); }
+
+    if (pipe_fds[0] >= 0) { close(pipe_fds[0]); }
+
+    out->wall_ns = bench_now_ns() - start;
+    // /dev/null keeps no count; what was handed to the writer is the next best thing
+    out->bytes = bench_sink_pipe ? drain.bytes : posted_bytes;
+
+    for (s = 0; s < BENCH_PIPE_SLOTS; s++) { free(slots[s]); }
+
+    free(hashes[0]);
+    free(hashes[1]);
+
+    return ret;
+}
+
+// the kitty frame path end to end against a pipe; shm sends escapes only, zlib is the remote stage's compress + base64
+static void bench_pipeline(void)
+{
+    fprintf(stdout, "\npipeline (%u frames, sink: %s, b64: %s)\n", BENCH_PIPE_FRAMES, bench_sink_pipe ? "pipe" : "/dev/null", yt_frame_b64_impl_get());
+    fprintf(stdout, "%-10s %-6s %-6s %8s %10s %10s %16s %16s %16s\n", "res", "fmt", "path", "fps", "MB/s", "sent", "render p50/p99", "stage p50/p99", "e2e p50/p99");
+
+    static const char *path_names[2] = { "shm", "zlib" };
+    yt_frame_fmt_t fmts[2] = { YT_FRAME_FMT_RGB24, YT_FRAME_FMT_RGBA32 };
+
+    uint32_t r = 0;
+    for (; r < sizeof(bench_resolutions) / sizeof(bench_resolutions[0]); r++)
+    {
+        const bench_res_t *res = &bench_resolutions[r];
+
+        char res_str[16] = LDG_ARR_ZERO_INIT;
+        snprintf(res_str, sizeof(res_str), "%ux%u", res->w, res->h);
+
+        uint32_t f = 0;
+        for (; f < 2; f++)
+        {
+            uint32_t p = 0;
+            for (; p < 2; p++)
+            {
+                bench_pipe_t run;
+                uint32_t ret = bench_pipe_run(res, fmts[f], (bench_path_t)p, &run);
+                if (LDG_UNLIKELY(ret != LDG_ERR_AOK))
+                {
+                    fprintf(stdout, "%-10s %-6s %-6s failed; ret: %u\n", res_str, yt_frame_fmt_name_get(fmts[f]), path_names[p], ret);
+                    continue;
+                }
+
+                double secs = run.wall_ns ? (double)run.wall_ns / 1e9 : 1.0;
+                char cols[3][24];
+                const yt_hist_t *hists[3] = { &run.render, &run.stage, &run.e2e };
+                uint32_t c = 0;
+                for (; c < 3; c++) { snprintf(cols[c], sizeof(cols[c]), "%lu/%luus", (unsigned long)(yt_hist_pct(hists[c], 500) / 1000), (unsigned long)(yt_hist_pct(hists[c], 990) / 1000)); }
+
+                fprintf(stdout, "%-10s %-6s %-6s %8.1f %10.1f %10lu %16s %16s %16s\n", res_str, yt_frame_fmt_name_get(fmts[f]), path_names[p], (double)run.sent / secs, (double)run.bytes / secs / 1e6, (unsigned long)run.sent, cols[0], cols[1], cols[2]);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // bench_render [section] [null]; no section runs everything
+    const char *only = (argc > 1) ? argv[1] : 0x0;
+    if (argc > 2 && strcmp(argv[2], "null") == 0) { bench_sink_pipe = 0; }
+
+    if (!only || strcmp(only, "alpha") == 0) { bench_alpha(); }
+
+    if (!only || strcmp(only, "tiles") == 0) { bench_tiles(); }
+
+    if (!only || strcmp(only, "text") == 0) { bench_text(); }
+
+    if (!only || strcmp(only, "pages") == 0) { bench_pages(); }
+
+    if (!only || strcmp(only, "stride") == 0) { bench_stride(); }
+
+    if (!only || strcmp(only, "pipeline") == 0) { bench_pipeline(); }
+
+    return 0;
+}
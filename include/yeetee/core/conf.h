@@ -12,6 +12,27 @@
 
 #define YT_CONF_DEFAULT_THUMB_CACHE_MAX 128
 #define YT_CONF_DEFAULT_POOL_WORKERS 4
+#define YT_CONF_DEFAULT_RENDER_RING_DEPTH 3
+#define YT_CONF_DEFAULT_RENDER_GOVERNOR 1
+#define YT_CONF_DEFAULT_RENDER_REMOTE_BUDGET 4096
+#define YT_CONF_DEFAULT_RENDER_PACE 1
+#define YT_CONF_DEFAULT_RENDER_FPS_CAP 0
+#define YT_CONF_DEFAULT_AUDIO_ONLY 0
+#define YT_CONF_DEFAULT_STREAM_CACHE_MAX 16
+#define YT_CONF_DEFAULT_STREAM_CACHE_DISK 0
+
+#define YT_CONF_RENDER_FMT_AUTO 0
+#define YT_CONF_RENDER_FMT_RGB24 1
+#define YT_CONF_RENDER_FMT_RGBA 2
+
+#define YT_CONF_RENDER_BACKEND_AUTO 0
+#define YT_CONF_RENDER_BACKEND_KITTY 1
+#define YT_CONF_RENDER_BACKEND_SIXEL 2
+#define YT_CONF_RENDER_BACKEND_CELLS 3
+
+#define YT_CONF_RENDER_REMOTE_AUTO 0
+#define YT_CONF_RENDER_REMOTE_ON 1
+#define YT_CONF_RENDER_REMOTE_OFF 2
 
 typedef struct yt_conf
 {
@@ -22,6 +43,17 @@ typedef struct yt_conf
     char cache_dir[YT_CONF_CACHE_DIR_MAX];
     uint32_t thumb_cache_max;
     uint32_t pool_workers;
+    uint32_t render_backend;
+    uint32_t render_fmt;
+    uint32_t render_ring_depth;
+    uint32_t render_governor;
+    uint32_t render_remote;
+    uint32_t render_remote_budget;
+    uint32_t render_pace;
+    uint32_t render_fps_cap;
+    uint32_t audio_only;
+    uint32_t stream_cache_max;
+    uint32_t stream_cache_disk;
 } yt_conf_t;
 
 uint32_t yt_conf_init(yt_conf_t *conf);
@@ -28,6 +28,7 @@
 #define YT_ERR_PLAYER_RENDER_INIT 762
 #define YT_ERR_PLAYER_RENDER 763
 #define YT_ERR_PLAYER_NO_STREAM 764
+#define YT_ERR_PLAYER_STREAM_EXPIRED 765
 
 // tui (780-799)
 #define YT_ERR_TUI_INIT 780
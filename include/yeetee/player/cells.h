@@ -0,0 +1,26 @@
+#ifndef YT_PLAYER_CELLS_H
+#define YT_PLAYER_CELLS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct yt_cells
+{
+    uint32_t *prev_top;
+    uint32_t *prev_bot;
+    uint8_t *changed;
+    size_t prev_cap;
+    uint32_t cols;
+    uint32_t rows;
+    char *out;
+    size_t out_cap;
+    size_t out_len;
+    uint32_t emit_cunt;
+    uint8_t pudding[4];
+} yt_cells_t;
+
+uint32_t yt_cells_encode(yt_cells_t *cells, const uint8_t *pixels, uint32_t w, uint32_t h, size_t stride, uint32_t row0, uint32_t rows, uint32_t abs_y, uint32_t abs_x);
+void yt_cells_invalidate(yt_cells_t *cells);
+void yt_cells_free(yt_cells_t *cells);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef YT_PLAYER_FRAME_H
+#define YT_PLAYER_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define YT_FRAME_BPP_MAX 4
+#define YT_FRAME_ALPHA_KERNEL_MAX 4
+#define YT_FRAME_B64_KERNEL_MAX 4
+#define YT_FRAME_QUANT_KERNEL_MAX 4
+#define YT_FRAME_PALETTE_SIZE 256
+#define YT_FRAME_B64_LEN(n) ((((n) + 2) / 3) * 4)
+#define YT_FRAME_TILE_PX 64
+#define YT_FRAME_TILES(n) (((n) + YT_FRAME_TILE_PX - 1) / YT_FRAME_TILE_PX)
+#define YT_FRAME_BAND_NONE UINT32_MAX
+
+typedef enum yt_frame_fmt
+{
+    YT_FRAME_FMT_RGB24 = 0,
+    YT_FRAME_FMT_RGBA32
+} yt_frame_fmt_t;
+
+typedef void (*yt_frame_alpha_fn_t)(uint8_t *buff, size_t len);
+
+typedef struct yt_frame_alpha_kernel
+{
+    const char *name;
+    yt_frame_alpha_fn_t fn;
+} yt_frame_alpha_kernel_t;
+
+typedef size_t (*yt_frame_b64_fn_t)(const uint8_t *src, size_t len, char *dst);
+
+typedef struct yt_frame_b64_kernel
+{
+    const char *name;
+    yt_frame_b64_fn_t fn;
+} yt_frame_b64_kernel_t;
+
+typedef void (*yt_frame_quant_fn_t)(const uint8_t *src, uint32_t w, uint32_t h, size_t stride, uint32_t y0, uint8_t *dst);
+
+typedef struct yt_frame_quant_kernel
+{
+    const char *name;
+    yt_frame_quant_fn_t fn;
+} yt_frame_quant_kernel_t;
+
+uint32_t yt_frame_fmt_bpp_get(yt_frame_fmt_t fmt);
+uint32_t yt_frame_fmt_kitty_get(yt_frame_fmt_t fmt);
+const char* yt_frame_fmt_mpv_get(yt_frame_fmt_t fmt);
+const char* yt_frame_fmt_name_get(yt_frame_fmt_t fmt);
+
+void yt_frame_alpha_fill(uint8_t *buff, size_t len);
+const char* yt_frame_alpha_impl_get(void);
+uint32_t yt_frame_alpha_kernels_get(yt_frame_alpha_kernel_t *kernels, uint32_t max);
+
+size_t yt_frame_b64_encode(const uint8_t *src, size_t len, char *dst, size_t dst_len);
+const char* yt_frame_b64_impl_get(void);
+uint32_t yt_frame_b64_kernels_get(yt_frame_b64_kernel_t *kernels, uint32_t max);
+
+void yt_frame_quant(const uint8_t *src, uint32_t w, uint32_t h, size_t stride, uint32_t y0, uint8_t *dst);
+void yt_frame_palette_get(uint32_t idx, uint32_t *r, uint32_t *g, uint32_t *b);
+const char* yt_frame_quant_impl_get(void);
+uint32_t yt_frame_quant_kernels_get(yt_frame_quant_kernel_t *kernels, uint32_t max);
+
+uint32_t yt_frame_tiles_hash(const uint8_t *buff, uint32_t w, uint32_t h, size_t stride, uint32_t bpp, uint64_t *out, uint32_t out_max);
+const char* yt_frame_hash_impl_get(void);
+uint32_t yt_frame_tiles_band(const uint64_t *prev, const uint64_t *next, uint32_t tile_cunt, uint32_t w, uint32_t h, uint32_t *rows);
+int yt_frame_kitty_band_esc(char *dst, size_t dst_len, yt_frame_fmt_t fmt, uint32_t w, size_t stride, uint32_t y0, uint32_t rows, uint32_t id, const char *name_b64);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef YT_PLAYER_HIST_H
+#define YT_PLAYER_HIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// log-linear buckets; 16 per power of two keeps every reading within ~6% up to 2^36 ns
+#define YT_HIST_SUB_BITS 4
+#define YT_HIST_SUB (1u << YT_HIST_SUB_BITS)
+#define YT_HIST_MAG_MAX 36
+#define YT_HIST_BUCKETS ((YT_HIST_MAG_MAX - YT_HIST_SUB_BITS + 2) * YT_HIST_SUB)
+
+typedef struct yt_hist
+{
+    uint64_t cunt;
+    uint64_t sum;
+    uint64_t max;
+    uint32_t buckets[YT_HIST_BUCKETS];
+} yt_hist_t;
+
+void yt_hist_reset(yt_hist_t *hist);
+void yt_hist_record(yt_hist_t *hist, uint64_t val);
+uint64_t yt_hist_pct(const yt_hist_t *hist, uint32_t per_mille);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef YT_PLAYER_OUTPUT_H
+#define YT_PLAYER_OUTPUT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+typedef struct yt_output_buff
+{
+    char *data;
+    size_t len;
+    size_t cap;
+} yt_output_buff_t;
+
+typedef struct yt_output
+{
+    pthread_t write_thread;
+    pthread_mutex_t mut;
+    pthread_cond_t cond;
+    yt_output_buff_t ui;
+    yt_output_buff_t video;
+    yt_output_buff_t ui_out;
+    yt_output_buff_t video_out;
+    uint64_t write_cunt;
+    uint64_t merge_cunt;
+    uint64_t bytes;
+    uint64_t err_cunt;
+    volatile uint8_t running;
+    uint8_t busy;
+    uint8_t pudding[6];
+} yt_output_t;
+
+uint32_t yt_output_init(yt_output_t *output);
+void yt_output_shutdown(yt_output_t *output);
+uint32_t yt_output_ui_post(yt_output_t *output, const char *buff, size_t len);
+uint32_t yt_output_video_post(yt_output_t *output, const struct iovec *iov, uint32_t iov_cunt);
+void yt_output_video_wait(yt_output_t *output);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef YT_PLAYER_PAGES_H
+#define YT_PLAYER_PAGES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define YT_PAGES_HUGE_SIZE ((size_t)2 << 20)
+#define YT_PAGES_STRIDE_ALIGN 64
+
+typedef enum yt_pages_kind
+{
+    YT_PAGES_KIND_SMALL = 0,
+    YT_PAGES_KIND_THP,
+    YT_PAGES_KIND_HUGETLB
+} yt_pages_kind_t;
+
+size_t yt_pages_huge_round(size_t size);
+size_t yt_pages_stride_align(size_t stride);
+yt_pages_kind_t yt_pages_advise(void *map, size_t size, uint8_t shmem);
+uint32_t yt_pages_hugetlb_open(size_t size, uint32_t *fd);
+const char* yt_pages_kind_name_get(yt_pages_kind_t kind);
+
+#endif
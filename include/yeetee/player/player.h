@@ -2,9 +2,8 @@
 #define YT_PLAYER_PLAYER_H
 
 #include <stdint.h>
-#include <pthread.h>
+#include <stdatomic.h>
 #include <mpv/client.h>
-#include <dangling/thread/spsc.h>
 
 typedef enum yt_player_state
 {
@@ -15,31 +14,62 @@ typedef enum yt_player_state
     YT_PLAYER_ERROR
 } yt_player_state_t;
 
+// edges the ui has to act on; everything else only moves the snapshot
+// eof_reached is a file that played out or failed, mpv moves on to the next playlist entry by itself
 typedef struct yt_player_event
 {
     yt_player_state_t state;
+    double aspect;
+    int32_t playlist_pos;
+    uint8_t eof_reached;
+    uint8_t state_changed;
+    uint8_t playlist_moved;
+    uint8_t pudding[1];
+} yt_player_event_t;
+
+// last value mpv reported for every observed property; cache_secs is how far the demuxer has read ahead
+// playlist_pos is the playing entry of mpv's playlist, -1 when nothing is
+typedef struct yt_player_snap
+{
+    yt_player_state_t state;
+    uint32_t volume;
     double time_pos;
     double duration;
+    double aspect;
+    double cache_secs;
+    int32_t playlist_pos;
+    uint8_t paused;
+    uint8_t buffering;
     uint8_t eof_reached;
-    uint8_t pudding[3];
-} yt_player_event_t;
+    uint8_t pudding[1];
+} yt_player_snap_t;
 
+// wake_fd turns readable whenever mpv has events queued; the owner polls it and drains with yt_player_event_poll
+// snap is written only by that owner and published through snap_seq; any thread reads it with yt_player_snap_get
 typedef struct yt_player
 {
     mpv_handle *mpv;
-    ldg_spsc_queue_t event_q;
-    pthread_t event_thread;
-    volatile uint8_t running;
-    uint8_t pudding[7];
+    yt_player_snap_t snap;
+    atomic_uint snap_seq;
+    uint32_t wake_fd;
 } yt_player_t;
 
 uint32_t yt_player_init(yt_player_t *player);
 void yt_player_shutdown(yt_player_t *player);
+uint32_t yt_player_event_poll(yt_player_t *player, yt_player_event_t *pe);
+uint32_t yt_player_snap_get(yt_player_t *player, yt_player_snap_t *snap);
+uint32_t yt_player_time_pos_get(yt_player_t *player, double *pos);
 uint32_t yt_player_load(yt_player_t *player, const char *url);
+uint32_t yt_player_load_at(yt_player_t *player, const char *url, double start_secs);
+uint32_t yt_player_append(yt_player_t *player, const char *url);
+uint32_t yt_player_playlist_play(yt_player_t *player, uint32_t idx);
+uint32_t yt_player_playlist_trim(yt_player_t *player);
 uint32_t yt_player_pause(yt_player_t *player);
 uint32_t yt_player_resume(yt_player_t *player);
 uint32_t yt_player_seek(yt_player_t *player, double secs);
 uint32_t yt_player_stop(yt_player_t *player);
 uint32_t yt_player_volume_set(yt_player_t *player, uint32_t volume);
+uint32_t yt_player_video_set(yt_player_t *player, uint8_t on);
+uint32_t yt_player_decode_set(yt_player_t *player, uint8_t on);
 
 #endif
@@ -0,0 +1,72 @@
+#ifndef YT_PLAYER_REMOTE_H
+#define YT_PLAYER_REMOTE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <yeetee/player/frame.h>
+#include <yeetee/player/hist.h>
+#include <yeetee/player/output.h>
+
+#define YT_REMOTE_CHUNK_MAX 4096
+#define YT_REMOTE_DEFAULT_BUDGET (4u * 1024u * 1024u)
+
+typedef struct yt_remote_job
+{
+    const uint8_t *pixels;
+    size_t stride;
+    yt_frame_fmt_t fmt;
+    uint32_t slot;
+    uint32_t kitty_id;
+    uint32_t pixel_w;
+    uint32_t pixel_h;
+    uint32_t dirty_y;
+    uint32_t dirty_rows;
+    uint32_t cur_y;
+    uint32_t cur_x;
+    uint32_t place_cols;
+    uint32_t place_rows;
+    uint32_t place_px_x;
+    uint32_t place_px_y;
+    uint64_t origin_ns;
+    uint8_t delta;
+    uint8_t pudding[3];
+} yt_remote_job_t;
+
+typedef struct yt_remote
+{
+    pthread_t stage_thread;
+    pthread_mutex_t mut;
+    pthread_cond_t cond;
+    yt_output_t *output;
+    yt_remote_job_t job;
+    uint8_t *z_buff;
+    size_t z_cap;
+    char *b64_buff;
+    size_t b64_cap;
+    char *out_buff;
+    size_t out_cap;
+    uint64_t bytes;
+    uint64_t stage_ns_avg;
+    yt_hist_t stage_hist;
+    yt_hist_t e2e_hist;
+    uint32_t done_mask;
+    uint32_t shown_id;
+    volatile uint8_t running;
+    uint8_t job_ready;
+    uint8_t busy;
+    uint8_t pudding[5];
+} yt_remote_t;
+
+uint32_t yt_remote_init(yt_remote_t *remote, yt_output_t *output);
+void yt_remote_shutdown(yt_remote_t *remote);
+size_t yt_remote_job_encode(yt_remote_t *remote, const yt_remote_job_t *job);
+uint32_t yt_remote_post(yt_remote_t *remote, const yt_remote_job_t *job);
+uint32_t yt_remote_reclaim(yt_remote_t *remote, yt_remote_job_t *job);
+void yt_remote_drain(yt_remote_t *remote);
+uint32_t yt_remote_done_take(yt_remote_t *remote);
+uint64_t yt_remote_stats_take(yt_remote_t *remote, uint64_t *stage_ns);
+uint32_t yt_remote_hist_get(yt_remote_t *remote, yt_hist_t *stage, yt_hist_t *e2e);
+uint8_t yt_remote_detect(void);
+
+#endif
@@ -7,37 +7,216 @@
 #include <mpv/client.h>
 #include <mpv/render.h>
 #include <notcurses/notcurses.h>
+#include <yeetee/player/frame.h>
+#include <yeetee/player/hist.h>
+#include <yeetee/player/pages.h>
+#include <yeetee/player/output.h>
+#include <yeetee/player/remote.h>
+#include <yeetee/player/sixel.h>
+#include <yeetee/player/cells.h>
+
+#define YT_RENDER_RING_MIN 2
+#define YT_RENDER_RING_MAX 8
+#define YT_RENDER_ESC_MAX 320
+#define YT_RENDER_SHM_PATH_MAX 64
+#define YT_RENDER_MAX_W 1920
+#define YT_RENDER_MAX_H 1080
+#define YT_RENDER_SKIP_MAX 4
+#define YT_RENDER_TILE_MAX (YT_FRAME_TILES(YT_RENDER_MAX_W) * YT_FRAME_TILES(YT_RENDER_MAX_H))
+
+typedef enum yt_render_slot_state
+{
+    YT_RENDER_SLOT_FREE = 0,
+    YT_RENDER_SLOT_STAGED,
+    YT_RENDER_SLOT_INFLIGHT
+} yt_render_slot_state_t;
+
+typedef enum yt_render_backend
+{
+    YT_RENDER_BACKEND_KITTY = 0,
+    YT_RENDER_BACKEND_SIXEL,
+    YT_RENDER_BACKEND_CELLS
+} yt_render_backend_t;
+
+typedef enum yt_render_stage
+{
+    YT_RENDER_STAGE_RENDER = 0,
+    YT_RENDER_STAGE_POST,
+    YT_RENDER_STAGE_WRITE,
+    YT_RENDER_STAGE_E2E,
+    YT_RENDER_STAGE_CUNT
+} yt_render_stage_t;
+
+// per frame timings in ns since the renderer started; e2e runs from mpv's update callback to the bytes reaching the output
+typedef struct yt_render_stats
+{
+    yt_hist_t stage[YT_RENDER_STAGE_CUNT];
+    uint64_t frame_cunt;
+    uint64_t drop_cunt;
+    uint64_t dup_cunt;
+    uint64_t delta_cunt;
+} yt_render_stats_t;
+
+typedef struct yt_render_opts
+{
+    yt_render_backend_t backend;
+    yt_output_t *output;
+    yt_frame_fmt_t fmt;
+    uint32_t ring_depth;
+    uint32_t remote_budget;
+    uint32_t fps_cap;
+    uint8_t governor;
+    uint8_t remote;
+    uint8_t pace;
+    uint8_t pudding[1];
+} yt_render_opts_t;
+
+typedef struct yt_render_geom
+{
+    uint32_t cell_px_x;
+    uint32_t cell_px_y;
+    uint32_t cell_cols;
+    uint32_t cell_rows;
+    uint32_t abs_y;
+    uint32_t abs_x;
+} yt_render_geom_t;
+
+// one rendered frame handed to the transmit stage; the band already includes damage from superseded frames
+// target_ns is the frame's presentation time on our clock when pacing, 0 sends it as soon as the stage is free
+typedef struct yt_render_job
+{
+    uint64_t now_ns;
+    uint64_t origin_ns;
+    uint64_t target_ns;
+    uint32_t slot;
+    uint32_t dirty_y;
+    uint32_t dirty_rows;
+    uint8_t full;
+    uint8_t pudding[3];
+} yt_render_job_t;
+
+typedef struct yt_render_slot
+{
+    uint8_t *map;
+    uint32_t fd;
+    uint32_t kitty_id;
+    uint32_t esc_len;
+    yt_render_slot_state_t state;
+    uint64_t sent_ns;
+    char path[YT_RENDER_SHM_PATH_MAX];
+    char name_b64[YT_FRAME_B64_LEN(YT_RENDER_SHM_PATH_MAX) + 1];
+    char esc_cmd[YT_RENDER_ESC_MAX];
+} yt_render_slot_t;
 
 typedef struct yt_render
 {
+    mpv_handle *mpv;
     mpv_render_context *ctx;
     struct ncplane *video_plane;
-    uint8_t *shm_map[2];
+    yt_render_slot_t slots[YT_RENDER_RING_MAX];
+    uint32_t slot_cunt;
+    uint32_t slot_next;
+    uint32_t shown_id;
+    uint32_t inst_id;
+    uint32_t id_base;
     size_t shm_size;
-    uint32_t shm_fd[2];
+    yt_pages_kind_t pages;
     uint32_t pixel_w;
     uint32_t pixel_h;
+    volatile uint32_t surface_wh;
+    uint32_t base_w;
+    uint32_t base_h;
+    yt_frame_fmt_t fmt;
     size_t stride;
+    size_t frame_size;
     uint32_t video_abs_y;
     uint32_t video_abs_x;
     uint32_t video_cell_cols;
     uint32_t video_cell_rows;
+    uint32_t cell_px_x;
+    uint32_t cell_px_y;
+    uint32_t place_col;
+    uint32_t place_row;
+    uint32_t place_cols;
+    uint32_t place_rows;
+    uint32_t place_px_x;
+    uint32_t place_px_y;
+    uint32_t aspect_milli;
+    volatile uint32_t aspect_req;
     uint64_t fps_epoch_ns;
     uint32_t frame_cunt;
     uint32_t fps;
-    uint32_t esc_len[2];
+    uint64_t drop_cunt;
+    uint64_t dup_cunt;
+    uint64_t delta_cunt;
+    uint64_t render_ns_avg;
+    uint64_t write_ns_avg;
+    volatile uint64_t update_ns;
+    uint64_t origin_ns;
+    pthread_mutex_t stats_mut;
+    yt_render_stats_t stats;
+    uint64_t gov_drop_mark;
+    uint32_t offer_cunt;
+    uint32_t gov_lvl;
+    uint32_t gov_good;
+    uint32_t gov_bad;
+    uint32_t gov_cooldown;
+    yt_render_backend_t backend;
+    yt_output_t *output;
+    yt_sixel_t sixel;
+    yt_cells_t cells;
+    yt_remote_t remote_stage;
+    uint64_t remote_budget;
+    uint32_t remote_skip;
+    volatile uint64_t frame_min_ns;
+    uint64_t cap_base_ns;
+    uint64_t cap_mark_ns;
+    uint32_t skip_phase;
+    uint32_t carry_y0;
+    uint32_t carry_y1;
+    uint64_t tile_hash[2][YT_RENDER_TILE_MAX];
+    uint32_t tile_cur;
+    uint32_t wake_fd;
     pthread_t render_thread;
-    pthread_mutex_t stdout_mut;
-    volatile uint8_t frame_ready;
+    pthread_t tx_thread;
+    pthread_mutex_t tx_mut;
+    pthread_cond_t tx_cond;
+    yt_render_job_t tx_job;
+    uint32_t tx_done_mask;
+    uint32_t tx_sent_mask;
+    uint32_t tx_swap_cunt;
+    uint64_t tx_delta_cunt;
+    uint64_t tx_dup_cunt;
+    pthread_mutex_t geom_mut;
+    yt_render_geom_t geom_req;
+    volatile uint32_t geom_gen;
+    uint32_t geom_seen;
     volatile uint8_t running;
-    uint8_t back;
-    uint8_t pudding[5];
-    char esc_cmd[2][256];
+    volatile uint8_t tx_running;
+    uint8_t tx_on;
+    uint8_t tx_ready;
+    uint8_t tx_busy;
+    uint8_t tx_fail;
+    uint8_t frame_pending;
+    uint8_t frame_drop;
+    uint8_t ack_seen;
+    uint8_t ack_off;
+    uint8_t tile_valid;
+    uint8_t gov_on;
+    uint8_t remote;
+    uint8_t carry;
+    uint8_t carry_full;
+    uint8_t pace;
+    uint8_t tx_hurry;
 } yt_render_t;
 
-uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *parent, uint32_t cell_rows, uint32_t cell_cols);
+uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *parent, uint32_t cell_rows, uint32_t cell_cols, const yt_render_opts_t *opts);
 void yt_render_shutdown(yt_render_t *render);
-void yt_render_stdout_lock(yt_render_t *render);
-void yt_render_stdout_unlock(yt_render_t *render);
+uint32_t yt_render_reconfigure(yt_render_t *render, struct ncplane *parent, uint32_t cell_rows, uint32_t cell_cols);
+uint32_t yt_render_place(yt_render_t *render, struct ncplane *parent, uint32_t y, uint32_t x, uint32_t cell_rows, uint32_t cell_cols);
+uint32_t yt_render_fps_cap_set(yt_render_t *render, uint32_t fps);
+uint32_t yt_render_aspect_set(yt_render_t *render, double aspect);
+uint32_t yt_render_surface_get(yt_render_t *render, uint32_t *w, uint32_t *h);
+uint32_t yt_render_stats_get(yt_render_t *render, yt_render_stats_t *stats);
 
 #endif
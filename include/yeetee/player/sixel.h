@@ -0,0 +1,23 @@
+#ifndef YT_PLAYER_SIXEL_H
+#define YT_PLAYER_SIXEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define YT_SIXEL_BAND_PX 6
+
+typedef struct yt_sixel
+{
+    uint8_t *idx;
+    size_t idx_cap;
+    uint8_t *bits;
+    size_t bits_cap;
+    char *out;
+    size_t out_cap;
+    size_t out_len;
+} yt_sixel_t;
+
+uint32_t yt_sixel_encode(yt_sixel_t *sixel, const uint8_t *pixels, uint32_t w, size_t stride, uint32_t y0, uint32_t rows);
+void yt_sixel_free(yt_sixel_t *sixel);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef YT_PLAYER_STREAM_H
+#define YT_PLAYER_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <yeetee/yeetee.h>
+
+// two escaped urls plus the edl headers
+#define YT_STREAM_EDL_MAX (2 * YT_STREAM_URL_MAX + 96)
+// a cached set has to outlast the play it is used for; range requests after expire= get a 403
+#define YT_STREAM_EXPIRE_MARGIN_SECS 1800
+#define YT_STREAM_CACHE_PATH_MAX 1024
+
+typedef enum yt_stream_codec
+{
+    YT_STREAM_CODEC_UNKNOWN = 0,
+    YT_STREAM_CODEC_AVC,
+    YT_STREAM_CODEC_VP9,
+    YT_STREAM_CODEC_AV1,
+    YT_STREAM_CODEC_CUNT
+} yt_stream_codec_t;
+
+// indices into the set; audio_idx is UINT32_MAX when the video stream carries its own audio or there is none
+typedef struct yt_stream_pick
+{
+    uint32_t video_idx;
+    uint32_t audio_idx;
+} yt_stream_pick_t;
+
+typedef struct yt_stream_cache_entry
+{
+    yt_stream_set_t set;
+    char video_id[YT_VIDEO_ID_MAX];
+    uint64_t expire_epoch;
+    uint64_t last_used;
+} yt_stream_cache_entry_t;
+
+// resolved sets by video id, least recently used out first; an entry goes once its urls are within the margin of expiring
+typedef struct yt_stream_cache
+{
+    yt_stream_cache_entry_t *entries;
+    uint32_t capacity;
+    uint32_t cunt;
+    uint64_t tick;
+} yt_stream_cache_t;
+
+yt_stream_codec_t yt_stream_codec_get(const yt_stream_t *stream);
+uint64_t yt_stream_cost_get(const yt_stream_t *stream);
+uint32_t yt_stream_pick(const yt_stream_set_t *set, uint32_t target_w, uint32_t target_h, yt_stream_pick_t *pick);
+uint32_t yt_stream_pick_audio(const yt_stream_set_t *set, yt_stream_pick_t *pick);
+uint8_t yt_stream_switch_worth(const yt_stream_set_t *set, const yt_stream_pick_t *cur, const yt_stream_pick_t *next, uint32_t target_w, uint32_t target_h);
+uint32_t yt_stream_edl_build(const char *video_url, const char *audio_url, char *out, size_t out_len);
+uint32_t yt_stream_url_build(const yt_stream_set_t *set, const yt_stream_pick_t *pick, char *out, size_t out_len);
+
+uint64_t yt_stream_expire_get(const yt_stream_set_t *set);
+uint32_t yt_stream_cache_init(yt_stream_cache_t *cache, uint32_t capacity);
+void yt_stream_cache_shutdown(yt_stream_cache_t *cache);
+const yt_stream_set_t* yt_stream_cache_get(yt_stream_cache_t *cache, const char *video_id, uint64_t now_epoch);
+uint32_t yt_stream_cache_put(yt_stream_cache_t *cache, const char *video_id, const yt_stream_set_t *set, uint64_t now_epoch);
+uint32_t yt_stream_cache_file_load(const char *cache_dir, const char *video_id, yt_stream_set_t *set, uint64_t now_epoch);
+uint32_t yt_stream_cache_file_save(const char *cache_dir, const char *video_id, const yt_stream_set_t *set);
+uint32_t yt_stream_cache_file_sweep(const char *cache_dir, uint64_t now_epoch);
+
+#endif
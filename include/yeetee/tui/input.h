@@ -24,7 +24,11 @@ typedef enum yt_action
     YT_ACTION_PREV,
     YT_ACTION_QUEUE_ADD,
     YT_ACTION_SHUFFLE,
-    YT_ACTION_REFRESH
+    YT_ACTION_REFRESH,
+    YT_ACTION_STATS,
+    YT_ACTION_PLAYER,
+    YT_ACTION_STOP,
+    YT_ACTION_AUDIO
 } yt_action_t;
 
 yt_action_t yt_input_dispatch(const struct ncinput *ni);
@@ -11,12 +11,15 @@
 #include <yeetee/auth/token.h>
 #include <yeetee/api/innertube.h>
 #include <yeetee/player/player.h>
+#include <yeetee/player/output.h>
 #include <yeetee/player/render.h>
+#include <yeetee/player/stream.h>
 #include <yeetee/tui/layout.h>
 #include <yeetee/tui/feed.h>
 #include <yeetee/tui/queue.h>
 
 #define YT_TUI_SEARCH_MAX 256
+#define YT_TUI_STREAM_SLOTS 2
 
 typedef enum yt_tui_view
 {
@@ -27,6 +30,16 @@ typedef enum yt_tui_view
     YT_TUI_VIEW_QUEUE
 } yt_tui_view_t;
 
+// resolved streams of a window entry; kept so the format can be picked again when the surface changes
+typedef struct yt_tui_stream
+{
+    yt_stream_set_t set;
+    yt_stream_pick_t pick;
+    char video_id[YT_VIDEO_ID_MAX];
+    uint32_t target_w;
+    uint32_t target_h;
+} yt_tui_stream_t;
+
 typedef struct yt_tui
 {
     struct notcurses *nc;
@@ -37,25 +50,47 @@ typedef struct yt_tui
     yt_innertube_ctx_t api;
     yt_player_t player;
     yt_render_t render;
+    yt_output_t output;
+    yt_render_stats_t render_stats;
     yt_feed_ctx_t feed;
     yt_queue_t queue;
     ldg_thread_pool_t pool;
     ldg_spsc_queue_t api_result_q;
     ldg_spsc_queue_t auth_result_q;
     ldg_spsc_queue_t stream_result_q;
+    ldg_spsc_queue_t spec_result_q;
     ldg_spsc_queue_t thumb_result_q;
+    yt_tui_stream_t streams[YT_TUI_STREAM_SLOTS];
+    yt_stream_cache_t stream_cache;
+    char spec_hover_id[YT_VIDEO_ID_MAX];
+    char spec_req_id[YT_VIDEO_ID_MAX];
+    uint64_t spec_hover_ns;
+    uint64_t stream_target_ns;
+    uint32_t stream_target_w;
+    uint32_t stream_target_h;
+    double video_aspect;
+    uint64_t resize_ns;
     char search_buff[YT_TUI_SEARCH_MAX];
     uint32_t search_len;
     yt_tui_view_t current_view;
     uint32_t auth_err;
     uint32_t thumb_req_cunt;
+    uint32_t playlist_base;
+    uint32_t playlist_len;
+    uint32_t stream_gen;
     volatile uint8_t running;
     uint8_t auth_started;
     uint8_t feed_req_pending;
     uint8_t player_ready;
     uint8_t stream_req_pending;
     uint8_t render_active;
-    uint8_t pudding[2];
+    uint8_t resize_pending;
+    uint8_t stats_visible;
+    uint8_t pip_active;
+    uint8_t audio_only;
+    uint8_t video_hidden;
+    uint8_t spec_tried;
+    uint8_t pudding[4];
 } yt_tui_t;
 
 uint32_t yt_tui_init(yt_tui_t *tui, yt_conf_t *conf);
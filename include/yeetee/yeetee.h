@@ -36,8 +36,10 @@ typedef struct yt_stream
     uint32_t width;
     uint32_t height;
     uint32_t bitrate;
+    uint32_t fps;
     uint8_t is_audio;
-    uint8_t pudding[3];
+    uint8_t muxed;
+    uint8_t pudding[2];
 } yt_stream_t;
 
 typedef struct yt_token
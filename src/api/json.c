@@ -565,6 +565,9 @@ static void json_stream_parse(cJSON *fmt, yt_stream_t *stream)
 
     tmp = cJSON_GetObjectItemCaseSensitive(fmt, "bitrate");
     if (tmp && cJSON_IsNumber(tmp)) { stream->bitrate = (uint32_t)tmp->valueint; }
+
+    tmp = cJSON_GetObjectItemCaseSensitive(fmt, "fps");
+    if (tmp && cJSON_IsNumber(tmp)) { stream->fps = (uint32_t)tmp->valueint; }
 }
 
 uint32_t yt_json_player_parse(const char *data, size_t len, yt_stream_set_t *streams)
@@ -595,6 +598,7 @@ uint32_t yt_json_player_parse(const char *data, size_t len, yt_stream_set_t *str
         {
             cJSON *fmt = cJSON_GetArrayItem(formats, (int)idx);
             json_stream_parse(fmt, &streams->streams[streams->stream_cunt]);
+            streams->streams[streams->stream_cunt].muxed = 1;
             if (streams->streams[streams->stream_cunt].url[0] != '\0') { streams->stream_cunt++; }
         }
     }
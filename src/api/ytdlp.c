@@ -113,16 +113,27 @@ static void ytdlp_formats_parse(cJSON *root, yt_stream_set_t *streams)
         tmp = cJSON_GetObjectItemCaseSensitive(fmt, "tbr");
         if (tmp && cJSON_IsNumber(tmp)) { stream->bitrate = (uint32_t)(tmp->valuedouble * 1000.0); }
 
+        tmp = cJSON_GetObjectItemCaseSensitive(fmt, "fps");
+        if (tmp && cJSON_IsNumber(tmp)) { stream->fps = (uint32_t)(tmp->valuedouble + 0.5); }
+
         cJSON *acodec = cJSON_GetObjectItemCaseSensitive(fmt, "acodec");
-        if (acodec && cJSON_IsString(acodec) && strcmp(acodec->valuestring, "none") != 0)
+        cJSON *vcodec = cJSON_GetObjectItemCaseSensitive(fmt, "vcodec");
+        uint8_t no_audio = (acodec && cJSON_IsString(acodec) && strcmp(acodec->valuestring, "none") == 0);
+        uint8_t no_video = (vcodec && cJSON_IsString(vcodec) && strcmp(vcodec->valuestring, "none") == 0);
+        uint8_t has_audio = (acodec && cJSON_IsString(acodec) && !no_audio);
+        uint8_t has_video = (vcodec && cJSON_IsString(vcodec) && !no_video);
+
+        // storyboards carry neither
+        if (no_audio && no_video) { continue; }
+
+        if (has_audio && !has_video)
         {
-            cJSON *vcodec = cJSON_GetObjectItemCaseSensitive(fmt, "vcodec");
-            if (vcodec && cJSON_IsString(vcodec) && strcmp(vcodec->valuestring, "none") == 0)
-            {
-                stream->is_audio = 1;
-                snprintf(stream->mime, sizeof(stream->mime), "%s", "audio/unknown");
-            }
+            stream->is_audio = 1;
+            snprintf(stream->mime, sizeof(stream->mime), "audio/unknown; codecs=\"%s\"", acodec->valuestring);
         }
+        else if (has_video) { snprintf(stream->mime, sizeof(stream->mime), "video/unknown; codecs=\"%s\"", vcodec->valuestring); }
+
+        stream->muxed = (has_audio && has_video);
 
         if (stream->mime[0] == '\0') { snprintf(stream->mime, sizeof(stream->mime), "%s", "video/unknown"); }
 
@@ -88,6 +88,98 @@ static uint32_t conf_line_parse(yt_conf_t *conf, const char *key, size_t key_len
         }
         conf->pool_workers = num;
     }
+    else if (key_len == 14 && memcmp(key, "render_backend", 14) == 0)
+    {
+        if (val_len == 4 && memcmp(val, "auto", 4) == 0) { conf->render_backend = YT_CONF_RENDER_BACKEND_AUTO; }
+        else if (val_len == 5 && memcmp(val, "kitty", 5) == 0) { conf->render_backend = YT_CONF_RENDER_BACKEND_KITTY; }
+        else if (val_len == 5 && memcmp(val, "sixel", 5) == 0) { conf->render_backend = YT_CONF_RENDER_BACKEND_SIXEL; }
+        else if (val_len == 5 && memcmp(val, "cells", 5) == 0) { conf->render_backend = YT_CONF_RENDER_BACKEND_CELLS; }
+        else{ return LDG_ERR_FUNC_ARG_INVALID; }
+    }
+    else if (key_len == 13 && memcmp(key, "render_format", 13) == 0)
+    {
+        if (val_len == 4 && memcmp(val, "auto", 4) == 0) { conf->render_fmt = YT_CONF_RENDER_FMT_AUTO; }
+        else if (val_len == 5 && memcmp(val, "rgb24", 5) == 0) { conf->render_fmt = YT_CONF_RENDER_FMT_RGB24; }
+        else if (val_len == 4 && memcmp(val, "rgba", 4) == 0) { conf->render_fmt = YT_CONF_RENDER_FMT_RGBA; }
+        else{ return LDG_ERR_FUNC_ARG_INVALID; }
+    }
+    else if (key_len == 17 && memcmp(key, "render_ring_depth", 17) == 0)
+    {
+        uint32_t num = 0;
+        for (size_t i = 0; i < val_len; i++)
+        {
+            if (LDG_UNLIKELY(val[i] < '0' || val[i] > '9')) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+            num = num * LDG_BASE_DECIMAL + (uint32_t)(val[i] - '0');
+        }
+        conf->render_ring_depth = num;
+    }
+    else if (key_len == 15 && memcmp(key, "render_governor", 15) == 0)
+    {
+        if (val_len == 1 && val[0] == '0') { conf->render_governor = 0; }
+        else if (val_len == 1 && val[0] == '1') { conf->render_governor = 1; }
+        else{ return LDG_ERR_FUNC_ARG_INVALID; }
+    }
+    else if (key_len == 13 && memcmp(key, "render_remote", 13) == 0)
+    {
+        if (val_len == 4 && memcmp(val, "auto", 4) == 0) { conf->render_remote = YT_CONF_RENDER_REMOTE_AUTO; }
+        else if (val_len == 2 && memcmp(val, "on", 2) == 0) { conf->render_remote = YT_CONF_RENDER_REMOTE_ON; }
+        else if (val_len == 3 && memcmp(val, "off", 3) == 0) { conf->render_remote = YT_CONF_RENDER_REMOTE_OFF; }
+        else{ return LDG_ERR_FUNC_ARG_INVALID; }
+    }
+    else if (key_len == 20 && memcmp(key, "render_remote_budget", 20) == 0)
+    {
+        uint32_t num = 0;
+        for (size_t i = 0; i < val_len; i++)
+        {
+            if (LDG_UNLIKELY(val[i] < '0' || val[i] > '9')) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+            num = num * LDG_BASE_DECIMAL + (uint32_t)(val[i] - '0');
+        }
+        conf->render_remote_budget = num;
+    }
+    else if (key_len == 11 && memcmp(key, "render_pace", 11) == 0)
+    {
+        if (val_len == 1 && val[0] == '0') { conf->render_pace = 0; }
+        else if (val_len == 1 && val[0] == '1') { conf->render_pace = 1; }
+        else{ return LDG_ERR_FUNC_ARG_INVALID; }
+    }
+    else if (key_len == 14 && memcmp(key, "render_fps_cap", 14) == 0)
+    {
+        uint32_t num = 0;
+        for (size_t i = 0; i < val_len; i++)
+        {
+            if (LDG_UNLIKELY(val[i] < '0' || val[i] > '9')) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+            num = num * LDG_BASE_DECIMAL + (uint32_t)(val[i] - '0');
+        }
+        conf->render_fps_cap = num;
+    }
+    else if (key_len == 10 && memcmp(key, "audio_only", 10) == 0)
+    {
+        if (val_len == 1 && val[0] == '0') { conf->audio_only = 0; }
+        else if (val_len == 1 && val[0] == '1') { conf->audio_only = 1; }
+        else{ return LDG_ERR_FUNC_ARG_INVALID; }
+    }
+    else if (key_len == 16 && memcmp(key, "stream_cache_max", 16) == 0)
+    {
+        uint32_t num = 0;
+        for (size_t i = 0; i < val_len; i++)
+        {
+            if (LDG_UNLIKELY(val[i] < '0' || val[i] > '9')) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+            num = num * LDG_BASE_DECIMAL + (uint32_t)(val[i] - '0');
+        }
+        if (LDG_UNLIKELY(num == 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+        conf->stream_cache_max = num;
+    }
+    else if (key_len == 17 && memcmp(key, "stream_cache_disk", 17) == 0)
+    {
+        if (val_len == 1 && val[0] == '0') { conf->stream_cache_disk = 0; }
+        else if (val_len == 1 && val[0] == '1') { conf->stream_cache_disk = 1; }
+        else{ return LDG_ERR_FUNC_ARG_INVALID; }
+    }
 
     return LDG_ERR_AOK;
 }
@@ -184,6 +276,17 @@ uint32_t yt_conf_init(yt_conf_t *conf)
     memcpy(conf->client_secret, YT_CONF_DEFAULT_CLIENT_SECRET, sizeof(YT_CONF_DEFAULT_CLIENT_SECRET));
     conf->thumb_cache_max = YT_CONF_DEFAULT_THUMB_CACHE_MAX;
     conf->pool_workers = YT_CONF_DEFAULT_POOL_WORKERS;
+    conf->render_backend = YT_CONF_RENDER_BACKEND_AUTO;
+    conf->render_fmt = YT_CONF_RENDER_FMT_AUTO;
+    conf->render_ring_depth = YT_CONF_DEFAULT_RENDER_RING_DEPTH;
+    conf->render_governor = YT_CONF_DEFAULT_RENDER_GOVERNOR;
+    conf->render_remote = YT_CONF_RENDER_REMOTE_AUTO;
+    conf->render_remote_budget = YT_CONF_DEFAULT_RENDER_REMOTE_BUDGET;
+    conf->render_pace = YT_CONF_DEFAULT_RENDER_PACE;
+    conf->render_fps_cap = YT_CONF_DEFAULT_RENDER_FPS_CAP;
+    conf->audio_only = YT_CONF_DEFAULT_AUDIO_ONLY;
+    conf->stream_cache_max = YT_CONF_DEFAULT_STREAM_CACHE_MAX;
+    conf->stream_cache_disk = YT_CONF_DEFAULT_STREAM_CACHE_DISK;
 
     return LDG_ERR_AOK;
 }
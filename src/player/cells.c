@@ -0,0 +1,207 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/player/cells.h>
+
+// 15-bit colour; decoder noise below it never repaints a cell
+#define YT_CELLS_MASK 0x00F8F8F8u
+#define YT_CELLS_LANES 4
+#define YT_CELLS_CUP_MAX 24
+#define YT_CELLS_SGR_MAX 48
+#define YT_CELLS_GLYPH "\xe2\x96\x80"
+#define YT_CELLS_GLYPH_LEN 3
+#define YT_CELLS_RESET "\x1b[0m"
+#define YT_CELLS_CELL_MAX (YT_CELLS_SGR_MAX + YT_CELLS_GLYPH_LEN)
+
+typedef uint32_t cells_vec_t __attribute__((vector_size(YT_CELLS_LANES * sizeof(uint32_t))));
+
+static uint32_t cells_reserve(void **buff, size_t *cap, size_t need)
+{
+    if (need <= *cap) { return LDG_ERR_AOK; }
+
+    void *grown = realloc(*buff, need);
+    if (LDG_UNLIKELY(!grown)) { return LDG_ERR_ALLOC_NULL; }
+
+    *buff = grown;
+    *cap = need;
+
+    return LDG_ERR_AOK;
+}
+
+// reduce one cell row to 15-bit top / bottom pairs against the previous frame; flags land in cells->changed
+static uint32_t cells_row_reduce(yt_cells_t *cells, const uint8_t *top, const uint8_t *bot, uint32_t w, size_t base)
+{
+    uint32_t *prev_top = cells->prev_top + base;
+    uint32_t *prev_bot = cells->prev_bot + base;
+    const cells_vec_t mask = { YT_CELLS_MASK, YT_CELLS_MASK, YT_CELLS_MASK, YT_CELLS_MASK };
+    uint32_t cunt = 0;
+
+    uint32_t x = 0;
+    for (; x + YT_CELLS_LANES <= w; x += YT_CELLS_LANES)
+    {
+        cells_vec_t t;
+        cells_vec_t b;
+        cells_vec_t pt;
+        cells_vec_t pb;
+        memcpy(&t, top + (size_t)x * 4, sizeof(t));
+        memcpy(&b, bot + (size_t)x * 4, sizeof(b));
+        memcpy(&pt, prev_top + x, sizeof(pt));
+        memcpy(&pb, prev_bot + x, sizeof(pb));
+
+        t &= mask;
+        b &= mask;
+        cells_vec_t diff = (cells_vec_t)((t != pt) | (b != pb)) & 1;
+
+        memcpy(prev_top + x, &t, sizeof(t));
+        memcpy(prev_bot + x, &b, sizeof(b));
+
+        uint32_t l = 0;
+        for (; l < YT_CELLS_LANES; l++)
+        {
+            cells->changed[x + l] = (uint8_t)diff[l];
+            cunt += diff[l];
+        }
+    }
+
+    for (; x < w; x++)
+    {
+        uint32_t t = 0;
+        uint32_t b = 0;
+        memcpy(&t, top + (size_t)x * 4, sizeof(t));
+        memcpy(&b, bot + (size_t)x * 4, sizeof(b));
+        t &= YT_CELLS_MASK;
+        b &= YT_CELLS_MASK;
+
+        uint8_t diff = (t != prev_top[x] || b != prev_bot[x]);
+        prev_top[x] = t;
+        prev_bot[x] = b;
+        cells->changed[x] = diff;
+        cunt += diff;
+    }
+
+    return cunt;
+}
+
+// rgb0 frame, two pixel rows per cell as upper half blocks; only cells whose colours moved are written
+uint32_t yt_cells_encode(yt_cells_t *cells, const uint8_t *pixels, uint32_t w, uint32_t h, size_t stride, uint32_t row0, uint32_t rows, uint32_t abs_y, uint32_t abs_x)
+{
+    if (LDG_UNLIKELY(!cells)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!pixels)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(w == 0 || h == 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    uint32_t cell_rows = (h + 1) / 2;
+    if (w != cells->cols || cell_rows != cells->rows)
+    {
+        size_t need = (size_t)w * cell_rows;
+        if (need > cells->prev_cap)
+        {
+            size_t cap = 0;
+            uint32_t err = cells_reserve((void **)&cells->prev_top, &cap, need * sizeof(uint32_t));
+            if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+            cap = 0;
+            err = cells_reserve((void **)&cells->prev_bot, &cap, need * sizeof(uint32_t));
+            if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+            cap = 0;
+            err = cells_reserve((void **)&cells->changed, &cap, need);
+            if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+            cells->prev_cap = need;
+        }
+
+        cells->cols = w;
+        cells->rows = cell_rows;
+        yt_cells_invalidate(cells);
+    }
+
+    if (row0 >= cell_rows) { row0 = cell_rows; }
+
+    if (rows > cell_rows - row0) { rows = cell_rows - row0; }
+
+    cells->out_len = 0;
+    cells->emit_cunt = 0;
+
+    size_t o = 0;
+    uint32_t cur_fg = UINT32_MAX;
+    uint32_t cur_bg = UINT32_MAX;
+
+    uint32_t cy = row0;
+    for (; cy < row0 + rows; cy++)
+    {
+        const uint8_t *top = pixels + (size_t)cy * 2 * stride;
+        const uint8_t *bot = (cy * 2 + 1 < h) ? top + stride : top;
+        size_t base = (size_t)cy * w;
+
+        uint32_t changed = cells_row_reduce(cells, top, bot, w, base);
+        if (changed == 0) { continue; }
+
+        uint32_t err = cells_reserve((void **)&cells->out, &cells->out_cap, o + (size_t)changed * (YT_CELLS_CELL_MAX + YT_CELLS_CUP_MAX) + sizeof(YT_CELLS_RESET));
+        if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+        char *out = cells->out;
+        uint32_t next_x = UINT32_MAX;
+
+        uint32_t x = 0;
+        for (; x < w; x++)
+        {
+            if (!cells->changed[x]) { continue; }
+
+            // the cursor advances by itself across a run; only gaps need a move
+            if (x != next_x) { o += (size_t)snprintf(out + o, YT_CELLS_CUP_MAX, "\x1b[%u;%uH", abs_y + cy + 1, abs_x + x + 1); }
+
+            uint32_t fg = cells->prev_top[base + x];
+            uint32_t bg = cells->prev_bot[base + x];
+            if (fg != cur_fg && bg != cur_bg) { o += (size_t)snprintf(out + o, YT_CELLS_SGR_MAX, "\x1b[38;2;%u;%u;%u;48;2;%u;%u;%um", fg & 0xFF, (fg >> 8) & 0xFF, (fg >> 16) & 0xFF, bg & 0xFF, (bg >> 8) & 0xFF, (bg >> 16) & 0xFF); }
+            else if (fg != cur_fg) { o += (size_t)snprintf(out + o, YT_CELLS_SGR_MAX, "\x1b[38;2;%u;%u;%um", fg & 0xFF, (fg >> 8) & 0xFF, (fg >> 16) & 0xFF); }
+            else if (bg != cur_bg) { o += (size_t)snprintf(out + o, YT_CELLS_SGR_MAX, "\x1b[48;2;%u;%u;%um", bg & 0xFF, (bg >> 8) & 0xFF, (bg >> 16) & 0xFF); }
+
+            cur_fg = fg;
+            cur_bg = bg;
+
+            memcpy(out + o, YT_CELLS_GLYPH, YT_CELLS_GLYPH_LEN);
+            o += YT_CELLS_GLYPH_LEN;
+            next_x = x + 1;
+        }
+
+        cells->emit_cunt += changed;
+    }
+
+    // leave the terminal's attributes as notcurses expects them
+    if (o > 0)
+    {
+        memcpy(cells->out + o, YT_CELLS_RESET, sizeof(YT_CELLS_RESET) - 1);
+        o += sizeof(YT_CELLS_RESET) - 1;
+    }
+
+    cells->out_len = o;
+
+    return LDG_ERR_AOK;
+}
+
+// masked colours never carry the top byte, so an all-ones entry always differs
+void yt_cells_invalidate(yt_cells_t *cells)
+{
+    if (LDG_UNLIKELY(!cells)) { return; }
+
+    size_t cunt = (size_t)cells->cols * cells->rows;
+    if (cells->prev_top) { memset(cells->prev_top, 0xFF, cunt * sizeof(uint32_t)); }
+
+    if (cells->prev_bot) { memset(cells->prev_bot, 0xFF, cunt * sizeof(uint32_t)); }
+}
+
+void yt_cells_free(yt_cells_t *cells)
+{
+    if (LDG_UNLIKELY(!cells)) { return; }
+
+    free(cells->prev_top);
+    free(cells->prev_bot);
+    free(cells->changed);
+    free(cells->out);
+    memset(cells, 0, sizeof(*cells));
+}
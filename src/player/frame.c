@@ -0,0 +1,608 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/player/frame.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define YT_FRAME_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define YT_FRAME_NEON 1
+#endif
+
+#define YT_FRAME_ALPHA_MASK 0xFF000000u
+#define YT_FRAME_HASH_LANES 8
+#define YT_FRAME_HASH_BLOCK (YT_FRAME_HASH_LANES * sizeof(uint32_t))
+#define YT_FRAME_HASH_P1 2654435761u
+#define YT_FRAME_HASH_P2 2246822519u
+#define YT_FRAME_HASH_P64 0x100000001B3ull
+
+// fmt
+uint32_t yt_frame_fmt_bpp_get(yt_frame_fmt_t fmt)
+{
+    if (fmt == YT_FRAME_FMT_RGB24) { return 3; }
+
+    return 4;
+}
+
+uint32_t yt_frame_fmt_kitty_get(yt_frame_fmt_t fmt)
+{
+    if (fmt == YT_FRAME_FMT_RGB24) { return 24; }
+
+    return 32;
+}
+
+const char* yt_frame_fmt_mpv_get(yt_frame_fmt_t fmt)
+{
+    if (fmt == YT_FRAME_FMT_RGB24) { return "rgb24"; }
+
+    return "rgb0";
+}
+
+const char* yt_frame_fmt_name_get(yt_frame_fmt_t fmt)
+{
+    if (fmt == YT_FRAME_FMT_RGB24) { return "rgb24"; }
+
+    return "rgba32";
+}
+
+// alpha kernels; len in bytes, multiple of 4, buff any alignment
+static void frame_alpha_fill_scalar(uint8_t *buff, size_t len)
+{
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) { buff[i + 3] = 0xFF; }
+}
+
+#if defined(YT_FRAME_X86)
+static void frame_alpha_fill_sse2(uint8_t *buff, size_t len)
+{
+    const __m128i mask = _mm_set1_epi32((int32_t)YT_FRAME_ALPHA_MASK);
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(buff + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(buff + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(buff + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(buff + i + 48));
+        _mm_storeu_si128((__m128i *)(buff + i), _mm_or_si128(a, mask));
+        _mm_storeu_si128((__m128i *)(buff + i + 16), _mm_or_si128(b, mask));
+        _mm_storeu_si128((__m128i *)(buff + i + 32), _mm_or_si128(c, mask));
+        _mm_storeu_si128((__m128i *)(buff + i + 48), _mm_or_si128(d, mask));
+    }
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(buff + i));
+        _mm_storeu_si128((__m128i *)(buff + i), _mm_or_si128(a, mask));
+    }
+
+    frame_alpha_fill_scalar(buff + i, len - i);
+}
+
+__attribute__((target("avx2"))) static void frame_alpha_fill_avx2(uint8_t *buff, size_t len)
+{
+    const __m256i mask = _mm256_set1_epi32((int32_t)YT_FRAME_ALPHA_MASK);
+    size_t i = 0;
+
+    for (; i + 128 <= len; i += 128)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(buff + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(buff + i + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(buff + i + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(buff + i + 96));
+        _mm256_storeu_si256((__m256i *)(buff + i), _mm256_or_si256(a, mask));
+        _mm256_storeu_si256((__m256i *)(buff + i + 32), _mm256_or_si256(b, mask));
+        _mm256_storeu_si256((__m256i *)(buff + i + 64), _mm256_or_si256(c, mask));
+        _mm256_storeu_si256((__m256i *)(buff + i + 96), _mm256_or_si256(d, mask));
+    }
+
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(buff + i));
+        _mm256_storeu_si256((__m256i *)(buff + i), _mm256_or_si256(a, mask));
+    }
+
+    frame_alpha_fill_scalar(buff + i, len - i);
+}
+#endif
+
+#if defined(YT_FRAME_NEON)
+static void frame_alpha_fill_neon(uint8_t *buff, size_t len)
+{
+    const uint32x4_t mask = vdupq_n_u32(YT_FRAME_ALPHA_MASK);
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64)
+    {
+        uint32x4_t a = vld1q_u32((const uint32_t *)(buff + i));
+        uint32x4_t b = vld1q_u32((const uint32_t *)(buff + i + 16));
+        uint32x4_t c = vld1q_u32((const uint32_t *)(buff + i + 32));
+        uint32x4_t d = vld1q_u32((const uint32_t *)(buff + i + 48));
+        vst1q_u32((uint32_t *)(buff + i), vorrq_u32(a, mask));
+        vst1q_u32((uint32_t *)(buff + i + 16), vorrq_u32(b, mask));
+        vst1q_u32((uint32_t *)(buff + i + 32), vorrq_u32(c, mask));
+        vst1q_u32((uint32_t *)(buff + i + 48), vorrq_u32(d, mask));
+    }
+
+    for (; i + 16 <= len; i += 16)
+    {
+        uint32x4_t a = vld1q_u32((const uint32_t *)(buff + i));
+        vst1q_u32((uint32_t *)(buff + i), vorrq_u32(a, mask));
+    }
+
+    frame_alpha_fill_scalar(buff + i, len - i);
+}
+#endif
+
+// dispatch
+static pthread_once_t frame_alpha_once = PTHREAD_ONCE_INIT;
+static yt_frame_alpha_kernel_t frame_alpha_best = { "scalar", frame_alpha_fill_scalar };
+
+static void frame_alpha_resolve(void)
+{
+    yt_frame_alpha_kernel_t kernels[YT_FRAME_ALPHA_KERNEL_MAX];
+    uint32_t cunt = yt_frame_alpha_kernels_get(kernels, YT_FRAME_ALPHA_KERNEL_MAX);
+
+    // kernels are listed slowest first
+    if (cunt > 0) { frame_alpha_best = kernels[cunt - 1]; }
+}
+
+uint32_t yt_frame_alpha_kernels_get(yt_frame_alpha_kernel_t *kernels, uint32_t max)
+{
+    if (LDG_UNLIKELY(!kernels)) { return 0; }
+
+    uint32_t cunt = 0;
+
+    if (cunt < max) { kernels[cunt].name = "scalar"; kernels[cunt].fn = frame_alpha_fill_scalar; cunt++; }
+
+#if defined(YT_FRAME_X86)
+    if (cunt < max) { kernels[cunt].name = "sse2"; kernels[cunt].fn = frame_alpha_fill_sse2; cunt++; }
+
+    __builtin_cpu_init();
+    if (cunt < max && __builtin_cpu_supports("avx2")) { kernels[cunt].name = "avx2"; kernels[cunt].fn = frame_alpha_fill_avx2; cunt++; }
+#elif defined(YT_FRAME_NEON)
+    if (cunt < max) { kernels[cunt].name = "neon"; kernels[cunt].fn = frame_alpha_fill_neon; cunt++; }
+#endif
+
+    return cunt;
+}
+
+void yt_frame_alpha_fill(uint8_t *buff, size_t len)
+{
+    if (LDG_UNLIKELY(!buff)) { return; }
+
+    pthread_once(&frame_alpha_once, frame_alpha_resolve);
+    frame_alpha_best.fn(buff, len);
+}
+
+const char* yt_frame_alpha_impl_get(void)
+{
+    pthread_once(&frame_alpha_once, frame_alpha_resolve);
+    return frame_alpha_best.name;
+}
+
+// b64 kernels; write exactly YT_FRAME_B64_LEN(len) bytes, no terminator
+static const char frame_b64_tab[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t frame_b64_scalar(const uint8_t *src, size_t len, char *dst)
+{
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 3 <= len; i += 3)
+    {
+        uint32_t v = ((uint32_t)src[i] << 16) | ((uint32_t)src[i + 1] << 8) | (uint32_t)src[i + 2];
+        dst[o++] = frame_b64_tab[(v >> 18) & 0x3F];
+        dst[o++] = frame_b64_tab[(v >> 12) & 0x3F];
+        dst[o++] = frame_b64_tab[(v >> 6) & 0x3F];
+        dst[o++] = frame_b64_tab[v & 0x3F];
+    }
+
+    if (i < len)
+    {
+        uint32_t v = (uint32_t)src[i] << 16;
+        if (i + 1 < len) { v |= (uint32_t)src[i + 1] << 8; }
+
+        dst[o++] = frame_b64_tab[(v >> 18) & 0x3F];
+        dst[o++] = frame_b64_tab[(v >> 12) & 0x3F];
+        dst[o++] = (i + 1 < len) ? frame_b64_tab[(v >> 6) & 0x3F] : '=';
+        dst[o++] = '=';
+    }
+
+    return o;
+}
+
+#if defined(YT_FRAME_X86)
+// 12 input bytes -> 16 sextets per step: pshufb spreads the triplets, two multiplies pull the sextets apart,
+// a second pshufb maps each sextet's range to the ascii offset for its class
+__attribute__((target("ssse3"))) static size_t frame_b64_ssse3(const uint8_t *src, size_t len, char *dst)
+{
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i mask_ac = _mm_set1_epi32(0x0FC0FC00);
+    const __m128i mul_ac = _mm_set1_epi32(0x04000040);
+    const __m128i mask_bd = _mm_set1_epi32(0x003F03F0);
+    const __m128i mul_bd = _mm_set1_epi32(0x01000010);
+    const __m128i offsets = _mm_setr_epi8(71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 65, 0, 0);
+    size_t i = 0;
+    size_t o = 0;
+
+    // loads 16 bytes per 12 consumed; stop while the over-read stays inside src
+    for (; i + 16 <= len; i += 12)
+    {
+        __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + i)), spread);
+        __m128i ac = _mm_mulhi_epu16(_mm_and_si128(in, mask_ac), mul_ac);
+        __m128i bd = _mm_mullo_epi16(_mm_and_si128(in, mask_bd), mul_bd);
+        __m128i idx = _mm_or_si128(ac, bd);
+
+        __m128i cls = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+        __m128i lower = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+        cls = _mm_or_si128(cls, _mm_and_si128(lower, _mm_set1_epi8(13)));
+        __m128i out = _mm_add_epi8(idx, _mm_shuffle_epi8(offsets, cls));
+
+        _mm_storeu_si128((__m128i *)(dst + o), out);
+        o += 16;
+    }
+
+    return o + frame_b64_scalar(src + i, len - i, dst + o);
+}
+#endif
+
+// dispatch
+static pthread_once_t frame_b64_once = PTHREAD_ONCE_INIT;
+static yt_frame_b64_fn_t frame_b64_fn = frame_b64_scalar;
+static const char *frame_b64_name = "scalar";
+
+static void frame_b64_resolve(void)
+{
+#if defined(YT_FRAME_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        frame_b64_fn = frame_b64_ssse3;
+        frame_b64_name = "ssse3";
+    }
+#endif
+}
+
+// returns encoded len, 0 if dst can't hold it plus the terminator
+size_t yt_frame_b64_encode(const uint8_t *src, size_t len, char *dst, size_t dst_len)
+{
+    if (LDG_UNLIKELY(!src || !dst)) { return 0; }
+
+    size_t out_len = YT_FRAME_B64_LEN(len);
+    if (LDG_UNLIKELY(out_len + LDG_STR_TERM_SIZE > dst_len)) { return 0; }
+
+    pthread_once(&frame_b64_once, frame_b64_resolve);
+    size_t o = frame_b64_fn(src, len, dst);
+    dst[o] = LDG_STR_TERM;
+
+    return o;
+}
+
+const char* yt_frame_b64_impl_get(void)
+{
+    pthread_once(&frame_b64_once, frame_b64_resolve);
+    return frame_b64_name;
+}
+
+uint32_t yt_frame_b64_kernels_get(yt_frame_b64_kernel_t *kernels, uint32_t max)
+{
+    if (LDG_UNLIKELY(!kernels)) { return 0; }
+
+    uint32_t cunt = 0;
+
+    if (cunt < max) { kernels[cunt].name = "scalar"; kernels[cunt].fn = frame_b64_scalar; cunt++; }
+
+#if defined(YT_FRAME_X86)
+    __builtin_cpu_init();
+    if (cunt < max && __builtin_cpu_supports("ssse3")) { kernels[cunt].name = "ssse3"; kernels[cunt].fn = frame_b64_ssse3; cunt++; }
+#endif
+
+    return cunt;
+}
+
+// tile hash; eight independent xxh32-style lanes per row segment, one vector op per step on any target
+typedef uint32_t frame_hash_vec_t __attribute__((vector_size(YT_FRAME_HASH_BLOCK)));
+
+static inline __attribute__((always_inline)) uint64_t frame_seg_hash(const uint8_t *p, size_t len)
+{
+    frame_hash_vec_t lanes = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    size_t i = 0;
+
+    for (; i + YT_FRAME_HASH_BLOCK <= len; i += YT_FRAME_HASH_BLOCK)
+    {
+        frame_hash_vec_t w;
+        memcpy(&w, p + i, YT_FRAME_HASH_BLOCK);
+
+        frame_hash_vec_t acc = lanes + w * YT_FRAME_HASH_P2;
+        lanes = ((acc << 13) | (acc >> 19)) * YT_FRAME_HASH_P1;
+    }
+
+    for (; i < len; i++) { lanes[i & (YT_FRAME_HASH_LANES - 1)] = (lanes[i & (YT_FRAME_HASH_LANES - 1)] ^ p[i]) * YT_FRAME_HASH_P1; }
+
+    // fold lanes pairwise; the segment digest only has to be cheap and order sensitive
+    uint64_t h = len;
+    uint32_t l = 0;
+    for (; l < YT_FRAME_HASH_LANES; l += 2) { h = (h ^ (((uint64_t)lanes[l] << 32) | lanes[l + 1])) * YT_FRAME_HASH_P64; }
+
+    return h;
+}
+
+// row major so the frame streams through once; each row segment folds into its tile's running hash
+static inline __attribute__((always_inline)) void frame_tiles_hash_body(const uint8_t *buff, uint32_t w, uint32_t h, size_t stride, uint32_t bpp, uint64_t *out)
+{
+    uint32_t tiles_x = YT_FRAME_TILES(w);
+    size_t tile_bytes = (size_t)YT_FRAME_TILE_PX * bpp;
+    size_t row_bytes = (size_t)w * bpp;
+
+    uint32_t y = 0;
+    for (; y < h; y++)
+    {
+        const uint8_t *row = buff + (size_t)y * stride;
+        uint64_t *tile_row = out + (size_t)(y / YT_FRAME_TILE_PX) * tiles_x;
+
+        uint32_t tx = 0;
+        for (; tx < tiles_x; tx++)
+        {
+            size_t off = (size_t)tx * tile_bytes;
+            size_t len = (off + tile_bytes <= row_bytes) ? tile_bytes : row_bytes - off;
+            tile_row[tx] = (tile_row[tx] ^ frame_seg_hash(row + off, len)) * YT_FRAME_HASH_P64;
+        }
+    }
+}
+
+static void frame_tiles_hash_generic(const uint8_t *buff, uint32_t w, uint32_t h, size_t stride, uint32_t bpp, uint64_t *out)
+{
+    frame_tiles_hash_body(buff, w, h, stride, bpp, out);
+}
+
+#if defined(YT_FRAME_X86)
+__attribute__((target("avx2"))) static void frame_tiles_hash_avx2(const uint8_t *buff, uint32_t w, uint32_t h, size_t stride, uint32_t bpp, uint64_t *out)
+{
+    frame_tiles_hash_body(buff, w, h, stride, bpp, out);
+}
+#endif
+
+typedef void (*frame_tiles_hash_fn_t)(const uint8_t *buff, uint32_t w, uint32_t h, size_t stride, uint32_t bpp, uint64_t *out);
+
+static pthread_once_t frame_hash_once = PTHREAD_ONCE_INIT;
+static frame_tiles_hash_fn_t frame_hash_fn = frame_tiles_hash_generic;
+static const char *frame_hash_name = "generic";
+
+static void frame_hash_resolve(void)
+{
+#if defined(YT_FRAME_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        frame_hash_fn = frame_tiles_hash_avx2;
+        frame_hash_name = "avx2";
+    }
+#endif
+}
+
+uint32_t yt_frame_tiles_hash(const uint8_t *buff, uint32_t w, uint32_t h, size_t stride, uint32_t bpp, uint64_t *out, uint32_t out_max)
+{
+    if (LDG_UNLIKELY(!buff || !out)) { return 0; }
+
+    uint32_t tile_cunt = YT_FRAME_TILES(w) * YT_FRAME_TILES(h);
+    if (LDG_UNLIKELY(tile_cunt == 0 || tile_cunt > out_max)) { return 0; }
+
+    memset(out, 0, tile_cunt * sizeof(uint64_t));
+
+    pthread_once(&frame_hash_once, frame_hash_resolve);
+    frame_hash_fn(buff, w, h, stride, bpp, out);
+
+    return tile_cunt;
+}
+
+const char* yt_frame_hash_impl_get(void)
+{
+    pthread_once(&frame_hash_once, frame_hash_resolve);
+    return frame_hash_name;
+}
+
+// only a full-width row band is contiguous in the shm file, so changed tiles collapse to their row span; returns the first row
+uint32_t yt_frame_tiles_band(const uint64_t *prev, const uint64_t *next, uint32_t tile_cunt, uint32_t w, uint32_t h, uint32_t *rows)
+{
+    if (LDG_UNLIKELY(!prev || !next || !rows)) { return YT_FRAME_BAND_NONE; }
+
+    *rows = 0;
+
+    uint32_t tiles_x = YT_FRAME_TILES(w);
+    if (LDG_UNLIKELY(tiles_x == 0)) { return YT_FRAME_BAND_NONE; }
+
+    uint32_t ty_min = UINT32_MAX;
+    uint32_t ty_max = 0;
+
+    uint32_t t = 0;
+    for (; t < tile_cunt; t++)
+    {
+        if (next[t] == prev[t]) { continue; }
+
+        uint32_t ty = t / tiles_x;
+        if (ty < ty_min) { ty_min = ty; }
+
+        if (ty > ty_max) { ty_max = ty; }
+    }
+
+    if (ty_min == UINT32_MAX) { return YT_FRAME_BAND_NONE; }
+
+    uint32_t y0 = ty_min * YT_FRAME_TILE_PX;
+    uint32_t y1 = (ty_max + 1) * YT_FRAME_TILE_PX;
+    if (y1 > h) { y1 = h; }
+
+    *rows = y1 - y0;
+    return y0;
+}
+
+// patch a row band of a shm slot into the shown image; returns the snprintf length
+int yt_frame_kitty_band_esc(char *dst, size_t dst_len, yt_frame_fmt_t fmt, uint32_t w, size_t stride, uint32_t y0, uint32_t rows, uint32_t id, const char *name_b64)
+{
+    return snprintf(dst, dst_len, "\x1b_Ga=f,r=1,X=1,q=2,f=%u,x=0,y=%u,s=%u,v=%u,O=%zu,S=%zu,i=%u,t=s;%s\x1b\\", yt_frame_fmt_kitty_get(fmt), y0, w, rows, (size_t)y0 * stride, (size_t)rows * stride, id, name_b64);
+}
+
+// palette quantizer; rgb0 to a fixed 3-3-2 cube with a 4x4 ordered dither, so static regions quantize identically frame to frame
+#define YT_FRAME_QUANT_PX 4
+
+static const uint8_t frame_bayer[YT_FRAME_QUANT_PX][YT_FRAME_QUANT_PX] = {
+    { 0, 8, 2, 10 },
+    { 12, 4, 14, 6 },
+    { 3, 11, 1, 9 },
+    { 15, 7, 13, 5 }
+};
+
+typedef uint8_t frame_quant_u8_t __attribute__((vector_size(YT_FRAME_QUANT_PX * sizeof(uint32_t))));
+typedef uint32_t frame_quant_u32_t __attribute__((vector_size(YT_FRAME_QUANT_PX * sizeof(uint32_t))));
+
+// dither offsets per channel, one 4 px rgb0 row per bayer row; red and green step 32, blue 64
+static void frame_dither_row(uint32_t y, uint8_t *out)
+{
+    uint32_t x = 0;
+    for (; x < YT_FRAME_QUANT_PX; x++)
+    {
+        uint8_t d = frame_bayer[y & (YT_FRAME_QUANT_PX - 1)][x];
+        out[x * 4 + 0] = (uint8_t)(d * 2);
+        out[x * 4 + 1] = (uint8_t)(d * 2);
+        out[x * 4 + 2] = (uint8_t)(d * 4);
+        out[x * 4 + 3] = 0;
+    }
+}
+
+static inline __attribute__((always_inline)) uint8_t frame_quant_px(const uint8_t *p, const uint8_t *d)
+{
+    uint32_t r = (uint32_t)p[0] + d[0];
+    uint32_t g = (uint32_t)p[1] + d[1];
+    uint32_t b = (uint32_t)p[2] + d[2];
+    if (r > 0xFF) { r = 0xFF; }
+
+    if (g > 0xFF) { g = 0xFF; }
+
+    if (b > 0xFF) { b = 0xFF; }
+
+    return (uint8_t)((r & 0xE0) | ((g >> 3) & 0x1C) | (b >> 6));
+}
+
+static void frame_quant_scalar(const uint8_t *src, uint32_t w, uint32_t h, size_t stride, uint32_t y0, uint8_t *dst)
+{
+    uint32_t y = 0;
+    for (; y < h; y++)
+    {
+        uint8_t dith[YT_FRAME_QUANT_PX * 4] = LDG_ARR_ZERO_INIT;
+        frame_dither_row(y0 + y, dith);
+
+        const uint8_t *row = src + (size_t)y * stride;
+        uint8_t *out = dst + (size_t)y * w;
+
+        uint32_t x = 0;
+        for (; x < w; x++) { out[x] = frame_quant_px(row + (size_t)x * 4, dith + (x & (YT_FRAME_QUANT_PX - 1)) * 4); }
+    }
+}
+
+// four pixels per step; saturating add, then the three channel fields shift straight into the index
+static inline __attribute__((always_inline)) void frame_quant_body(const uint8_t *src, uint32_t w, uint32_t h, size_t stride, uint32_t y0, uint8_t *dst)
+{
+    uint32_t y = 0;
+    for (; y < h; y++)
+    {
+        uint8_t dith[YT_FRAME_QUANT_PX * 4] = LDG_ARR_ZERO_INIT;
+        frame_dither_row(y0 + y, dith);
+
+        frame_quant_u8_t dv;
+        memcpy(&dv, dith, sizeof(dv));
+
+        const uint8_t *row = src + (size_t)y * stride;
+        uint8_t *out = dst + (size_t)y * w;
+
+        uint32_t x = 0;
+        for (; x + YT_FRAME_QUANT_PX <= w; x += YT_FRAME_QUANT_PX)
+        {
+            frame_quant_u8_t v;
+            memcpy(&v, row + (size_t)x * 4, sizeof(v));
+
+            frame_quant_u8_t s = v + dv;
+            s |= (frame_quant_u8_t)(s < v);
+
+            frame_quant_u32_t q = (frame_quant_u32_t)s;
+            frame_quant_u32_t idx = (q & 0xE0) | ((q >> 11) & 0x1C) | ((q >> 22) & 0x03);
+
+            out[x + 0] = (uint8_t)idx[0];
+            out[x + 1] = (uint8_t)idx[1];
+            out[x + 2] = (uint8_t)idx[2];
+            out[x + 3] = (uint8_t)idx[3];
+        }
+
+        for (; x < w; x++) { out[x] = frame_quant_px(row + (size_t)x * 4, dith + (x & (YT_FRAME_QUANT_PX - 1)) * 4); }
+    }
+}
+
+static void frame_quant_generic(const uint8_t *src, uint32_t w, uint32_t h, size_t stride, uint32_t y0, uint8_t *dst)
+{
+    frame_quant_body(src, w, h, stride, y0, dst);
+}
+
+#if defined(YT_FRAME_X86)
+__attribute__((target("avx2"))) static void frame_quant_avx2(const uint8_t *src, uint32_t w, uint32_t h, size_t stride, uint32_t y0, uint8_t *dst)
+{
+    frame_quant_body(src, w, h, stride, y0, dst);
+}
+#endif
+
+static pthread_once_t frame_quant_once = PTHREAD_ONCE_INIT;
+static yt_frame_quant_kernel_t frame_quant_best = { "generic", frame_quant_generic };
+
+static void frame_quant_resolve(void)
+{
+#if defined(YT_FRAME_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        frame_quant_best.name = "avx2";
+        frame_quant_best.fn = frame_quant_avx2;
+    }
+#endif
+}
+
+void yt_frame_quant(const uint8_t *src, uint32_t w, uint32_t h, size_t stride, uint32_t y0, uint8_t *dst)
+{
+    if (LDG_UNLIKELY(!src || !dst)) { return; }
+
+    pthread_once(&frame_quant_once, frame_quant_resolve);
+    frame_quant_best.fn(src, w, h, stride, y0, dst);
+}
+
+void yt_frame_palette_get(uint32_t idx, uint32_t *r, uint32_t *g, uint32_t *b)
+{
+    *r = ((idx >> 5) & 0x07) * 255 / 7;
+    *g = ((idx >> 2) & 0x07) * 255 / 7;
+    *b = (idx & 0x03) * 255 / 3;
+}
+
+const char* yt_frame_quant_impl_get(void)
+{
+    pthread_once(&frame_quant_once, frame_quant_resolve);
+    return frame_quant_best.name;
+}
+
+uint32_t yt_frame_quant_kernels_get(yt_frame_quant_kernel_t *kernels, uint32_t max)
+{
+    if (LDG_UNLIKELY(!kernels)) { return 0; }
+
+    uint32_t cunt = 0;
+
+    if (cunt < max) { kernels[cunt].name = "scalar"; kernels[cunt].fn = frame_quant_scalar; cunt++; }
+
+    if (cunt < max) { kernels[cunt].name = "generic"; kernels[cunt].fn = frame_quant_generic; cunt++; }
+
+#if defined(YT_FRAME_X86)
+    __builtin_cpu_init();
+    if (cunt < max && __builtin_cpu_supports("avx2")) { kernels[cunt].name = "avx2"; kernels[cunt].fn = frame_quant_avx2; cunt++; }
+#endif
+
+    return cunt;
+}
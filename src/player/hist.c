@@ -0,0 +1,70 @@
+#include <stdint.h>
+#include <string.h>
+#include <dangling/core/macros.h>
+#include <yeetee/player/hist.h>
+
+static uint32_t hist_idx(uint64_t val)
+{
+    if (val < YT_HIST_SUB) { return (uint32_t)val; }
+
+    uint32_t mag = 63u - (uint32_t)__builtin_clzll(val);
+    if (mag > YT_HIST_MAG_MAX) { return YT_HIST_BUCKETS - 1; }
+
+    uint32_t top = (uint32_t)(val >> (mag - YT_HIST_SUB_BITS));
+    return (mag - YT_HIST_SUB_BITS + 1) * YT_HIST_SUB + (top - YT_HIST_SUB);
+}
+
+// highest value that lands in the bucket; percentiles never read low
+static uint64_t hist_idx_high(uint32_t idx)
+{
+    if (idx < YT_HIST_SUB) { return idx; }
+
+    uint32_t mag = idx / YT_HIST_SUB + YT_HIST_SUB_BITS - 1;
+    uint64_t top = YT_HIST_SUB + idx % YT_HIST_SUB;
+    uint32_t shift = mag - YT_HIST_SUB_BITS;
+
+    return ((top + 1) << shift) - 1;
+}
+
+void yt_hist_reset(yt_hist_t *hist)
+{
+    if (LDG_UNLIKELY(!hist)) { return; }
+
+    memset(hist, 0, sizeof(*hist));
+}
+
+void yt_hist_record(yt_hist_t *hist, uint64_t val)
+{
+    if (LDG_UNLIKELY(!hist)) { return; }
+
+    hist->buckets[hist_idx(val)]++;
+    hist->cunt++;
+    hist->sum += val;
+    if (val > hist->max) { hist->max = val; }
+}
+
+// per_mille 500 is the median, 990 the p99; the top bucket reports the exact max
+uint64_t yt_hist_pct(const yt_hist_t *hist, uint32_t per_mille)
+{
+    if (LDG_UNLIKELY(!hist)) { return 0; }
+
+    if (hist->cunt == 0) { return 0; }
+
+    if (per_mille >= 1000) { return hist->max; }
+
+    uint64_t rank = (hist->cunt * per_mille + 999) / 1000;
+    if (rank == 0) { rank = 1; }
+
+    uint64_t seen = 0;
+    uint32_t b = 0;
+    for (; b < YT_HIST_BUCKETS; b++)
+    {
+        seen += hist->buckets[b];
+        if (seen < rank) { continue; }
+
+        uint64_t high = hist_idx_high(b);
+        return (high < hist->max) ? high : hist->max;
+    }
+
+    return hist->max;
+}
@@ -0,0 +1,249 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <syslog.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/core/err.h>
+#include <yeetee/player/output.h>
+
+#define YT_OUTPUT_SYNC_BEGIN "\x1b[?2026h"
+#define YT_OUTPUT_SYNC_END "\x1b[?2026l"
+#define YT_OUTPUT_POLL_MS 100
+#define YT_OUTPUT_BUFF_MIN 4096
+#define YT_OUTPUT_IOV_CUNT 4
+
+static uint32_t output_buff_append(yt_output_buff_t *buff, const void *src, size_t len)
+{
+    if (buff->len + len > buff->cap)
+    {
+        size_t cap = (buff->cap != 0) ? buff->cap : YT_OUTPUT_BUFF_MIN;
+        while (cap < buff->len + len) { cap *= 2; }
+
+        char *grown = (char *)realloc(buff->data, cap);
+        if (LDG_UNLIKELY(!grown)) { return LDG_ERR_ALLOC_NULL; }
+
+        buff->data = grown;
+        buff->cap = cap;
+    }
+
+    memcpy(buff->data + buff->len, src, len);
+    buff->len += len;
+
+    return LDG_ERR_AOK;
+}
+
+static void output_buff_swap(yt_output_buff_t *a, yt_output_buff_t *b)
+{
+    yt_output_buff_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+// notcurses leaves stdout non-blocking; a slow terminal parks the writer here, never a producer
+static uint32_t output_writev_all(struct iovec *iov, uint32_t iov_cunt)
+{
+    uint32_t i = 0;
+    while (i < iov_cunt)
+    {
+        if (iov[i].iov_len == 0)
+        {
+            i++;
+            continue;
+        }
+
+        ssize_t wr = writev(STDOUT_FILENO, iov + i, (int)(iov_cunt - i));
+        if (wr > 0)
+        {
+            size_t left = (size_t)wr;
+            while (i < iov_cunt && left >= iov[i].iov_len)
+            {
+                left -= iov[i].iov_len;
+                i++;
+            }
+
+            if (i < iov_cunt)
+            {
+                iov[i].iov_base = (char *)iov[i].iov_base + left;
+                iov[i].iov_len -= left;
+            }
+
+            continue;
+        }
+
+        if (wr < 0 && errno == EINTR) { continue; }
+
+        if (wr < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            struct pollfd pfd = LDG_STRUCT_ZERO_INIT;
+            pfd.fd = STDOUT_FILENO;
+            pfd.events = POLLOUT;
+            poll(&pfd, 1, YT_OUTPUT_POLL_MS);
+            continue;
+        }
+
+        return LDG_ERR_IO_WRITE;
+    }
+
+    return LDG_ERR_AOK;
+}
+
+// everything queued since the last write goes out as one writev in one synchronized update
+static void* output_write_loop(void *arg)
+{
+    yt_output_t *output = (yt_output_t *)arg;
+
+    pthread_mutex_lock(&output->mut);
+    for (;;)
+    {
+        while (output->running && output->ui.len == 0 && output->video.len == 0) { pthread_cond_wait(&output->cond, &output->mut); }
+
+        // stopping; whatever was queued before shutdown still reaches the terminal
+        if (output->ui.len == 0 && output->video.len == 0) { break; }
+
+        output_buff_swap(&output->ui, &output->ui_out);
+        output_buff_swap(&output->video, &output->video_out);
+        output->ui.len = 0;
+        output->video.len = 0;
+        output->busy = 1;
+        pthread_cond_broadcast(&output->cond);
+        pthread_mutex_unlock(&output->mut);
+
+        // ui first; kitty images and sixels then land over the cells notcurses just wrote
+        struct iovec iov[YT_OUTPUT_IOV_CUNT] = {
+            { (void *)YT_OUTPUT_SYNC_BEGIN, sizeof(YT_OUTPUT_SYNC_BEGIN) - 1 },
+            { output->ui_out.data, output->ui_out.len },
+            { output->video_out.data, output->video_out.len },
+            { (void *)YT_OUTPUT_SYNC_END, sizeof(YT_OUTPUT_SYNC_END) - 1 }
+        };
+
+        uint32_t err = output_writev_all(iov, YT_OUTPUT_IOV_CUNT);
+
+        pthread_mutex_lock(&output->mut);
+        output->busy = 0;
+        output->write_cunt++;
+        output->bytes += output->ui_out.len + output->video_out.len;
+        if (output->ui_out.len != 0 && output->video_out.len != 0) { output->merge_cunt++; }
+
+        if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+        {
+            if (output->err_cunt == 0) { syslog(LOG_ERR, "output_write_loop; writev failed; errno: %d", errno); }
+
+            output->err_cunt++;
+        }
+
+        pthread_cond_broadcast(&output->cond);
+    }
+
+    pthread_mutex_unlock(&output->mut);
+
+    return 0x0;
+}
+
+uint32_t yt_output_init(yt_output_t *output)
+{
+    if (LDG_UNLIKELY(!output)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    memset(output, 0, sizeof(*output));
+    pthread_mutex_init(&output->mut, 0x0);
+    pthread_cond_init(&output->cond, 0x0);
+
+    output->running = 1;
+    int pret = pthread_create(&output->write_thread, 0x0, output_write_loop, output);
+    if (LDG_UNLIKELY(pret != 0))
+    {
+        syslog(LOG_ERR, "output_init; pthread_create failed; ret: %d", pret);
+        output->running = 0;
+        pthread_cond_destroy(&output->cond);
+        pthread_mutex_destroy(&output->mut);
+        return YT_ERR_PLAYER_RENDER_INIT;
+    }
+
+    return LDG_ERR_AOK;
+}
+
+void yt_output_shutdown(yt_output_t *output)
+{
+    if (LDG_UNLIKELY(!output)) { return; }
+
+    if (output->running)
+    {
+        pthread_mutex_lock(&output->mut);
+        output->running = 0;
+        pthread_cond_broadcast(&output->cond);
+        pthread_mutex_unlock(&output->mut);
+
+        int join_ret = pthread_join(output->write_thread, 0x0);
+        if (LDG_UNLIKELY(join_ret != 0)) { syslog(LOG_ERR, "output_shutdown; pthread_join failed; ret: %d", join_ret); }
+
+        pthread_cond_destroy(&output->cond);
+        pthread_mutex_destroy(&output->mut);
+
+        syslog(LOG_INFO, "output_shutdown; writes: %lu; merged: %lu; bytes: %lu; errors: %lu", (unsigned long)output->write_cunt, (unsigned long)output->merge_cunt, (unsigned long)output->bytes, (unsigned long)output->err_cunt);
+    }
+
+    free(output->ui.data);
+    free(output->video.data);
+    free(output->ui_out.data);
+    free(output->video_out.data);
+    memset(output, 0, sizeof(*output));
+}
+
+// notcurses diffs against what it last rasterized, so ui output is appended, never replaced
+uint32_t yt_output_ui_post(yt_output_t *output, const char *buff, size_t len)
+{
+    if (LDG_UNLIKELY(!output)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!buff)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!output->running)) { return LDG_ERR_NOT_INIT; }
+
+    if (len == 0) { return LDG_ERR_AOK; }
+
+    pthread_mutex_lock(&output->mut);
+    uint32_t err = output_buff_append(&output->ui, buff, len);
+    pthread_cond_broadcast(&output->cond);
+    pthread_mutex_unlock(&output->mut);
+
+    return err;
+}
+
+// one frame's escapes; the pieces stay contiguous so nothing interleaves inside a kitty command
+uint32_t yt_output_video_post(yt_output_t *output, const struct iovec *iov, uint32_t iov_cunt)
+{
+    if (LDG_UNLIKELY(!output)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!iov)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!output->running)) { return LDG_ERR_NOT_INIT; }
+
+    uint32_t err = LDG_ERR_AOK;
+
+    pthread_mutex_lock(&output->mut);
+    size_t mark = output->video.len;
+    uint32_t i = 0;
+    for (; i < iov_cunt && err == LDG_ERR_AOK; i++) { err = output_buff_append(&output->video, iov[i].iov_base, iov[i].iov_len); }
+
+    // half an escape would corrupt everything after it
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { output->video.len = mark; }
+
+    pthread_cond_broadcast(&output->cond);
+    pthread_mutex_unlock(&output->mut);
+
+    return err;
+}
+
+void yt_output_video_wait(yt_output_t *output)
+{
+    if (LDG_UNLIKELY(!output)) { return; }
+
+    pthread_mutex_lock(&output->mut);
+    while (output->running && output->video.len != 0) { pthread_cond_wait(&output->cond, &output->mut); }
+
+    pthread_mutex_unlock(&output->mut);
+}
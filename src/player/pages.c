@@ -0,0 +1,94 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/core/err.h>
+#include <yeetee/player/pages.h>
+
+#define YT_PAGES_THP_ANON "/sys/kernel/mm/transparent_hugepage/enabled"
+#define YT_PAGES_THP_SHMEM "/sys/kernel/mm/transparent_hugepage/shmem_enabled"
+#define YT_PAGES_MODE_MAX 128
+
+// the bracketed word is the active mode; never and deny ignore the advice, anything else honours it
+static uint8_t pages_thp_on(const char *path)
+{
+    FILE *f = fopen(path, "re");
+    if (LDG_UNLIKELY(!f)) { return 0; }
+
+    char mode[YT_PAGES_MODE_MAX] = LDG_ARR_ZERO_INIT;
+    size_t rd = fread(mode, 1, sizeof(mode) - 1, f);
+    fclose(f);
+    mode[rd] = '\0';
+
+    const char *open = strchr(mode, '[');
+    if (!open) { return 0; }
+
+    return strncmp(open, "[never]", 7) != 0 && strncmp(open, "[deny]", 6) != 0;
+}
+
+// a partial huge page at the tail would fall back to small pages for the whole extent
+size_t yt_pages_huge_round(size_t size)
+{
+    return (size + YT_PAGES_HUGE_SIZE - 1) & ~(YT_PAGES_HUGE_SIZE - 1);
+}
+
+// one cache line and one avx-512 vector; rows start aligned so kernels never split a load across lines
+size_t yt_pages_stride_align(size_t stride)
+{
+    return (stride + YT_PAGES_STRIDE_ALIGN - 1) & ~((size_t)YT_PAGES_STRIDE_ALIGN - 1);
+}
+
+// advisory only; reports whether the kernel policy will actually back the range with huge pages
+yt_pages_kind_t yt_pages_advise(void *map, size_t size, uint8_t shmem)
+{
+    if (LDG_UNLIKELY(!map)) { return YT_PAGES_KIND_SMALL; }
+
+    if (madvise(map, size, MADV_HUGEPAGE) != 0) { return YT_PAGES_KIND_SMALL; }
+
+    return pages_thp_on(shmem ? YT_PAGES_THP_SHMEM : YT_PAGES_THP_ANON) ? YT_PAGES_KIND_THP : YT_PAGES_KIND_SMALL;
+}
+
+// explicit huge pages; fails unless the admin reserved a pool, the mmap is where the reservation is taken
+uint32_t yt_pages_hugetlb_open(size_t size, uint32_t *fd)
+{
+    if (LDG_UNLIKELY(!fd)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(size == 0 || (size & (YT_PAGES_HUGE_SIZE - 1)) != 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    int mfd = memfd_create("yeetee-frame", MFD_CLOEXEC | MFD_HUGETLB);
+    if (mfd < 0) { return YT_ERR_PLAYER_RENDER_INIT; }
+
+    if (ftruncate(mfd, (off_t)size) != 0)
+    {
+        close(mfd);
+        return YT_ERR_PLAYER_RENDER_INIT;
+    }
+
+    *fd = (uint32_t)mfd;
+
+    return LDG_ERR_AOK;
+}
+
+const char* yt_pages_kind_name_get(yt_pages_kind_t kind)
+{
+    switch (kind)
+    {
+        case YT_PAGES_KIND_SMALL:
+            return "4k";
+
+        case YT_PAGES_KIND_THP:
+            return "thp";
+
+        case YT_PAGES_KIND_HUGETLB:
+            return "hugetlb";
+    }
+
+    return "unknown";
+}
@@ -1,73 +1,214 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
+#include <unistd.h>
 #include <syslog.h>
-#include <pthread.h>
+#include <sys/eventfd.h>
 #include <mpv/client.h>
 #include <dangling/core/macros.h>
 #include <dangling/core/err.h>
-#include <dangling/thread/spsc.h>
 #include <yeetee/core/err.h>
 #include <yeetee/player/player.h>
 
-static void* event_loop(void *arg)
+// mpv's own threads; nothing but a nudge for whoever polls wake_fd
+static void player_wakeup_cb(void *arg)
 {
     yt_player_t *player = (yt_player_t *)arg;
 
-    while (player->running)
+    uint64_t one = 1;
+    ssize_t wr = write((int)player->wake_fd, &one, sizeof(one));
+    (void)wr;
+}
+
+// reply ids for mpv_observe_property
+typedef enum player_prop
+{
+    PLAYER_PROP_TIME_POS = 1,
+    PLAYER_PROP_DURATION,
+    PLAYER_PROP_PAUSE,
+    PLAYER_PROP_PLAYLIST_POS,
+    PLAYER_PROP_ASPECT,
+    PLAYER_PROP_VOLUME,
+    PLAYER_PROP_CACHE,
+    PLAYER_PROP_BUFFERING
+} player_prop_t;
+
+// seqlock writer; odd while the snapshot is torn, a reader that sees odd or a moved counter copies again
+static void player_snap_begin(yt_player_t *player)
+{
+    unsigned seq = atomic_load_explicit(&player->snap_seq, memory_order_relaxed);
+    atomic_store_explicit(&player->snap_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void player_snap_end(yt_player_t *player)
+{
+    unsigned seq = atomic_load_explicit(&player->snap_seq, memory_order_relaxed);
+    atomic_store_explicit(&player->snap_seq, seq + 1, memory_order_release);
+}
+
+static double player_prop_double(const mpv_event_property *prop)
+{
+    if (prop->format == MPV_FORMAT_DOUBLE) { return *(double *)prop->data; }
+
+    if (prop->format == MPV_FORMAT_INT64) { return (double)*(int64_t *)prop->data; }
+
+    // MPV_FORMAT_NONE; the property went away, nothing is loaded
+    return 0.0;
+}
+
+static uint8_t player_prop_flag(const mpv_event_property *prop)
+{
+    return (prop->format == MPV_FORMAT_FLAG) ? (uint8_t)(*(int *)prop->data != 0) : 0;
+}
+
+// one observed property into the snapshot; returns 1 with pe filled when the ui has to react
+static uint8_t player_prop_apply(yt_player_t *player, uint64_t id, const mpv_event_property *prop, yt_player_event_t *pe)
+{
+    yt_player_snap_t *snap = &player->snap;
+    uint8_t edge = 0;
+
+    player_snap_begin(player);
+    switch ((player_prop_t)id)
+    {
+        case PLAYER_PROP_TIME_POS:
+            snap->time_pos = player_prop_double(prop);
+            break;
+
+        case PLAYER_PROP_DURATION:
+            snap->duration = player_prop_double(prop);
+            break;
+
+        case PLAYER_PROP_PAUSE:
+            snap->paused = player_prop_flag(prop);
+            if (snap->state == YT_PLAYER_PLAYING || snap->state == YT_PLAYER_PAUSED) { snap->state = snap->paused ? YT_PLAYER_PAUSED : YT_PLAYER_PLAYING; }
+
+            edge = 1;
+            break;
+
+        case PLAYER_PROP_PLAYLIST_POS:
+            snap->playlist_pos = (prop->format == MPV_FORMAT_INT64) ? (int32_t)*(int64_t *)prop->data : -1;
+            edge = 1;
+            break;
+
+        case PLAYER_PROP_ASPECT:
+            snap->aspect = player_prop_double(prop);
+            edge = (snap->aspect > 0.0);
+            break;
+
+        case PLAYER_PROP_VOLUME:
+            snap->volume = (uint32_t)(player_prop_double(prop) + 0.5);
+            edge = 1;
+            break;
+
+        case PLAYER_PROP_CACHE:
+            snap->cache_secs = player_prop_double(prop);
+            break;
+
+        case PLAYER_PROP_BUFFERING:
+            snap->buffering = player_prop_flag(prop);
+            edge = 1;
+            break;
+
+        default:
+            break;
+    }
+
+    player_snap_end(player);
+
+    if (!edge) { return 0; }
+
+    pe->state = snap->state;
+    pe->aspect = (id == PLAYER_PROP_ASPECT) ? snap->aspect : 0.0;
+    pe->playlist_pos = snap->playlist_pos;
+    pe->playlist_moved = (id == PLAYER_PROP_PLAYLIST_POS);
+    pe->state_changed = (id != PLAYER_PROP_ASPECT);
+
+    return 1;
+}
+
+static void player_state_set(yt_player_t *player, yt_player_state_t state)
+{
+    player_snap_begin(player);
+    player->snap.state = state;
+    if (state == YT_PLAYER_STOPPED)
     {
-        mpv_event *ev = mpv_wait_event(player->mpv, 0.1);
-        if (LDG_UNLIKELY(!ev)) { continue; }
+        player->snap.time_pos = 0.0;
+        player->snap.cache_secs = 0.0;
+    }
 
-        if (ev->event_id == MPV_EVENT_NONE) { continue; }
+    player_snap_end(player);
+}
 
-        if (ev->event_id == MPV_EVENT_SHUTDOWN) { break; }
+// one mpv event into the snapshot; returns 0 for events the ui never sees
+static uint8_t player_event_apply(yt_player_t *player, const mpv_event *ev, yt_player_event_t *pe)
+{
+    memset(pe, 0, sizeof(*pe));
 
-        if (ev->event_id == MPV_EVENT_PROPERTY_CHANGE)
+    switch (ev->event_id)
+    {
+        case MPV_EVENT_PROPERTY_CHANGE:
         {
             mpv_event_property *prop = (mpv_event_property *)ev->data;
-            if (LDG_UNLIKELY(!prop)) { continue; }
-
-            yt_player_event_t pe = LDG_STRUCT_ZERO_INIT;
-            pe.state = YT_PLAYER_PLAYING;
-
-            if (ev->reply_userdata == 1 && prop->format == MPV_FORMAT_DOUBLE) { pe.time_pos = *(double *)prop->data; }
-            else if (ev->reply_userdata == 2 && prop->format == MPV_FORMAT_DOUBLE) { pe.duration = *(double *)prop->data; }
-            else if (ev->reply_userdata == 3 && prop->format == MPV_FORMAT_FLAG)
-            {
-                int paused = *(int *)prop->data;
-                pe.state = paused ? YT_PLAYER_PAUSED : YT_PLAYER_PLAYING;
-            }
-            else if (ev->reply_userdata == 4 && prop->format == MPV_FORMAT_FLAG)
-            {
-                int eof = *(int *)prop->data;
-                pe.eof_reached = (uint8_t)eof;
-            }
-
-            ldg_spsc_push(&player->event_q, &pe);
+            if (LDG_UNLIKELY(!prop)) { return 0; }
+
+            return player_prop_apply(player, ev->reply_userdata, prop, pe);
+        }
+
+        case MPV_EVENT_START_FILE:
+            player_state_set(player, YT_PLAYER_LOADING);
+            player_snap_begin(player);
+            player->snap.eof_reached = 0;
+            player_snap_end(player);
+
+            pe->state = YT_PLAYER_LOADING;
+            pe->state_changed = 1;
+            return 1;
+
+        case MPV_EVENT_PLAYBACK_RESTART:
+        {
+            yt_player_state_t state = player->snap.paused ? YT_PLAYER_PAUSED : YT_PLAYER_PLAYING;
+            if (player->snap.state == state) { return 0; }
+
+            player_state_set(player, state);
+            pe->state = state;
+            pe->state_changed = 1;
+            return 1;
         }
 
-        if (ev->event_id == MPV_EVENT_END_FILE)
+        case MPV_EVENT_END_FILE:
         {
             mpv_event_end_file *ef = (mpv_event_end_file *)ev->data;
             uint32_t reason = ef ? (uint32_t)ef->reason : 999;
             int32_t err_code = ef ? ef->error : 0;
             syslog(LOG_INFO, "mpv end_file; reason: %u; err: %d", reason, err_code);
 
-            yt_player_event_t pe = LDG_STRUCT_ZERO_INIT;
-            pe.state = YT_PLAYER_STOPPED;
-            pe.eof_reached = 1;
-            ldg_spsc_push(&player->event_q, &pe);
+            // stop, quit and a replacing loadfile end the file too; only a played out or broken one counts
+            uint8_t eof = (ef && (ef->reason == MPV_END_FILE_REASON_EOF || ef->reason == MPV_END_FILE_REASON_ERROR));
+
+            player_state_set(player, YT_PLAYER_STOPPED);
+            player_snap_begin(player);
+            player->snap.eof_reached = eof;
+            player_snap_end(player);
+
+            pe->state = YT_PLAYER_STOPPED;
+            pe->playlist_pos = player->snap.playlist_pos;
+            pe->eof_reached = eof;
+            pe->state_changed = 1;
+            return 1;
         }
 
-        if (ev->event_id == MPV_EVENT_LOG_MESSAGE)
+        case MPV_EVENT_LOG_MESSAGE:
         {
             mpv_event_log_message *msg = (mpv_event_log_message *)ev->data;
             if (msg) { syslog(LOG_INFO, "mpv [%s] %s: %s", msg->level, msg->prefix, msg->text); }
+
+            return 0;
         }
-    }
 
-    return 0x0;
+        default:
+            return 0;
+    }
 }
 
 uint32_t yt_player_init(yt_player_t *player)
@@ -75,9 +216,26 @@ uint32_t yt_player_init(yt_player_t *player)
     if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
 
     memset(player, 0, sizeof(*player));
+    atomic_init(&player->snap_seq, 0);
+    player->snap.playlist_pos = -1;
+    player->wake_fd = UINT32_MAX;
+
+    int wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (LDG_UNLIKELY(wake_fd < 0))
+    {
+        syslog(LOG_ERR, "%s", "player_init; eventfd failed");
+        return YT_ERR_PLAYER_INIT;
+    }
+
+    player->wake_fd = (uint32_t)wake_fd;
 
     player->mpv = mpv_create();
-    if (LDG_UNLIKELY(!player->mpv)) { return YT_ERR_PLAYER_INIT; }
+    if (LDG_UNLIKELY(!player->mpv))
+    {
+        close((int)player->wake_fd);
+        player->wake_fd = UINT32_MAX;
+        return YT_ERR_PLAYER_INIT;
+    }
 
     mpv_set_option_string(player->mpv, "vo", "libmpv");
     mpv_set_option_string(player->mpv, "ao", "pulse,alsa");
@@ -88,59 +246,125 @@ uint32_t yt_player_init(yt_player_t *player)
     mpv_set_option_string(player->mpv, "cache", "yes");
     mpv_set_option_string(player->mpv, "demuxer-max-bytes", "52428800");
     mpv_set_option_string(player->mpv, "demuxer-readahead-secs", "30");
+    // the next playlist entry is opened and demuxed while the current one is still playing
+    mpv_set_option_string(player->mpv, "prefetch-playlist", "yes");
 
     int ret = mpv_initialize(player->mpv);
     if (LDG_UNLIKELY(ret < 0))
     {
         mpv_destroy(player->mpv);
         player->mpv = 0x0;
+        close((int)player->wake_fd);
+        player->wake_fd = UINT32_MAX;
         return YT_ERR_PLAYER_INIT;
     }
 
+    // mpv only notifies when the value changes in the asked format; whole seconds keep time-pos and the cache at 1 Hz
     mpv_request_log_messages(player->mpv, "warn");
-    mpv_observe_property(player->mpv, 1, "time-pos", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(player->mpv, 2, "duration", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(player->mpv, 3, "pause", MPV_FORMAT_FLAG);
-    mpv_observe_property(player->mpv, 4, "eof-reached", MPV_FORMAT_FLAG);
+    mpv_observe_property(player->mpv, PLAYER_PROP_TIME_POS, "time-pos", MPV_FORMAT_INT64);
+    mpv_observe_property(player->mpv, PLAYER_PROP_DURATION, "duration", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(player->mpv, PLAYER_PROP_PAUSE, "pause", MPV_FORMAT_FLAG);
+    mpv_observe_property(player->mpv, PLAYER_PROP_PLAYLIST_POS, "playlist-playing-pos", MPV_FORMAT_INT64);
+    mpv_observe_property(player->mpv, PLAYER_PROP_ASPECT, "video-params/aspect", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(player->mpv, PLAYER_PROP_VOLUME, "volume", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(player->mpv, PLAYER_PROP_CACHE, "demuxer-cache-duration", MPV_FORMAT_INT64);
+    mpv_observe_property(player->mpv, PLAYER_PROP_BUFFERING, "paused-for-cache", MPV_FORMAT_FLAG);
+
+    // events stay in mpv's queue until the owner drains them; the fd only says there is something to read
+    mpv_set_wakeup_callback(player->mpv, player_wakeup_cb, player);
+    mpv_wakeup(player->mpv);
 
-    uint32_t err = ldg_spsc_init(&player->event_q, sizeof(yt_player_event_t), 64);
-    if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+    return LDG_ERR_AOK;
+}
+
+void yt_player_shutdown(yt_player_t *player)
+{
+    if (LDG_UNLIKELY(!player)) { return; }
+
+    if (player->mpv)
     {
+        mpv_set_wakeup_callback(player->mpv, 0x0, 0x0);
         mpv_terminate_destroy(player->mpv);
         player->mpv = 0x0;
-        return err;
     }
 
-    player->running = 1;
+    if (player->wake_fd != UINT32_MAX)
+    {
+        close((int)player->wake_fd);
+        player->wake_fd = UINT32_MAX;
+    }
+}
+
+// next event the ui cares about; LDG_ERR_EMPTY once mpv's queue is dry and wake_fd is rearmed
+uint32_t yt_player_event_poll(yt_player_t *player, yt_player_event_t *pe)
+{
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!pe)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!player->mpv)) { return LDG_ERR_NOT_INIT; }
 
-    int pret = pthread_create(&player->event_thread, 0x0, event_loop, player);
-    if (LDG_UNLIKELY(pret != 0))
+    uint8_t rearmed = 0;
+    for (;;)
     {
-        ldg_spsc_shutdown(&player->event_q);
-        mpv_terminate_destroy(player->mpv);
-        player->mpv = 0x0;
-        player->running = 0;
-        return YT_ERR_PLAYER_INIT;
+        mpv_event *ev = mpv_wait_event(player->mpv, 0);
+        if (LDG_UNLIKELY(!ev)) { return LDG_ERR_EMPTY; }
+
+        if (ev->event_id == MPV_EVENT_NONE)
+        {
+            if (rearmed) { return LDG_ERR_EMPTY; }
+
+            // clear, then look once more; anything queued after the clear writes the fd again
+            uint64_t wakeups = 0;
+            ssize_t rd = read((int)player->wake_fd, &wakeups, sizeof(wakeups));
+            (void)rd;
+            rearmed = 1;
+            continue;
+        }
+
+        if (player_event_apply(player, ev, pe)) { return LDG_ERR_AOK; }
     }
+}
 
-    return LDG_ERR_AOK;
+// lock free; never enters mpv, so the ui can call it on every draw
+uint32_t yt_player_snap_get(yt_player_t *player, yt_player_snap_t *snap)
+{
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!snap)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    for (;;)
+    {
+        unsigned seq = atomic_load_explicit(&player->snap_seq, memory_order_acquire);
+        if (seq & 1u) { continue; }
+
+        memcpy(snap, &player->snap, sizeof(*snap));
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(&player->snap_seq, memory_order_relaxed) == seq) { return LDG_ERR_AOK; }
+    }
 }
 
-void yt_player_shutdown(yt_player_t *player)
+// the snapshot's time-pos is whole seconds for the progress bar; a reload or seek asks mpv for the exact one
+uint32_t yt_player_time_pos_get(yt_player_t *player, double *pos)
 {
-    if (LDG_UNLIKELY(!player)) { return; }
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
 
-    player->running = 0;
-    int join_ret = pthread_join(player->event_thread, 0x0);
-    if (LDG_UNLIKELY(join_ret != 0)) { syslog(LOG_ERR, "player_shutdown; pthread_join failed; ret: %d", join_ret); }
+    if (LDG_UNLIKELY(!pos)) { return LDG_ERR_FUNC_ARG_NULL; }
 
-    ldg_spsc_shutdown(&player->event_q);
+    if (LDG_UNLIKELY(!player->mpv)) { return LDG_ERR_NOT_INIT; }
 
-    if (player->mpv)
+    double val = 0.0;
+    if (mpv_get_property(player->mpv, "time-pos", MPV_FORMAT_DOUBLE, &val) < 0)
     {
-        mpv_terminate_destroy(player->mpv);
-        player->mpv = 0x0;
+        yt_player_snap_t snap = LDG_STRUCT_ZERO_INIT;
+        yt_player_snap_get(player, &snap);
+        val = snap.time_pos;
     }
+
+    *pos = val;
+
+    return LDG_ERR_AOK;
 }
 
 uint32_t yt_player_load(yt_player_t *player, const char *url)
@@ -158,6 +382,94 @@ uint32_t yt_player_load(yt_player_t *player, const char *url)
     return LDG_ERR_AOK;
 }
 
+// replaces the playing file and starts it at start_secs; named args, so it works on either side of mpv 0.38's
+// extra index parameter
+uint32_t yt_player_load_at(yt_player_t *player, const char *url, double start_secs)
+{
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!url)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!player->mpv)) { return LDG_ERR_NOT_INIT; }
+
+    char start_str[32] = LDG_ARR_ZERO_INIT;
+    snprintf(start_str, sizeof(start_str), "%.1f", start_secs);
+
+    char *opt_keys[] = { (char *)"start" };
+    mpv_node opt_vals[1] = LDG_ARR_ZERO_INIT;
+    opt_vals[0].format = MPV_FORMAT_STRING;
+    opt_vals[0].u.string = start_str;
+    mpv_node_list opts = { .num = 1, .values = opt_vals, .keys = opt_keys };
+
+    char *keys[] = { (char *)"name", (char *)"url", (char *)"flags", (char *)"options" };
+    mpv_node vals[4] = LDG_ARR_ZERO_INIT;
+    vals[0].format = MPV_FORMAT_STRING;
+    vals[0].u.string = (char *)"loadfile";
+    vals[1].format = MPV_FORMAT_STRING;
+    vals[1].u.string = (char *)url;
+    vals[2].format = MPV_FORMAT_STRING;
+    vals[2].u.string = (char *)"replace";
+    vals[3].format = MPV_FORMAT_NODE_MAP;
+    vals[3].u.list = &opts;
+    mpv_node_list args = { .num = 4, .values = vals, .keys = keys };
+
+    mpv_node cmd = LDG_STRUCT_ZERO_INIT;
+    cmd.format = MPV_FORMAT_NODE_MAP;
+    cmd.u.list = &args;
+
+    int ret = mpv_command_node(player->mpv, &cmd, 0x0);
+    if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
+
+    return LDG_ERR_AOK;
+}
+
+// queued behind whatever is loaded, or played right away when mpv sits idle at the end of its playlist
+// with prefetch-playlist the entry after the playing one is opened early
+uint32_t yt_player_append(yt_player_t *player, const char *url)
+{
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!url)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!player->mpv)) { return LDG_ERR_NOT_INIT; }
+
+    const char *cmd[] = { "loadfile", url, "append-play", 0x0 };
+    int ret = mpv_command(player->mpv, cmd);
+    if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
+
+    return LDG_ERR_AOK;
+}
+
+uint32_t yt_player_playlist_play(yt_player_t *player, uint32_t idx)
+{
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!player->mpv)) { return LDG_ERR_NOT_INIT; }
+
+    char idx_str[16] = LDG_ARR_ZERO_INIT;
+    snprintf(idx_str, sizeof(idx_str), "%u", idx);
+
+    const char *cmd[] = { "playlist-play-index", idx_str, 0x0 };
+    int ret = mpv_command(player->mpv, cmd);
+    if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
+
+    return LDG_ERR_AOK;
+}
+
+// drops every entry but the playing one, which becomes entry 0
+uint32_t yt_player_playlist_trim(yt_player_t *player)
+{
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!player->mpv)) { return LDG_ERR_NOT_INIT; }
+
+    const char *cmd[] = { "playlist-clear", 0x0 };
+    int ret = mpv_command(player->mpv, cmd);
+    if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
+
+    return LDG_ERR_AOK;
+}
+
 uint32_t yt_player_pause(yt_player_t *player)
 {
     if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
@@ -168,6 +480,11 @@ uint32_t yt_player_pause(yt_player_t *player)
     int ret = mpv_command(player->mpv, cmd);
     if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
 
+    // published now so a second key press toggles back; the observed property confirms it shortly
+    player_snap_begin(player);
+    player->snap.paused = 1;
+    player_snap_end(player);
+
     return LDG_ERR_AOK;
 }
 
@@ -181,6 +498,10 @@ uint32_t yt_player_resume(yt_player_t *player)
     int ret = mpv_command(player->mpv, cmd);
     if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
 
+    player_snap_begin(player);
+    player->snap.paused = 0;
+    player_snap_end(player);
+
     return LDG_ERR_AOK;
 }
 
@@ -226,5 +547,42 @@ uint32_t yt_player_volume_set(yt_player_t *player, uint32_t volume)
     int ret = mpv_command(player->mpv, cmd);
     if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
 
+    player_snap_begin(player);
+    player->snap.volume = volume;
+    player_snap_end(player);
+
     return LDG_ERR_AOK;
 }
+
+// vid=no keeps mpv from opening a decoder at all; the setting outlives the file
+static uint32_t player_vid_set(yt_player_t *player, uint8_t on)
+{
+    if (LDG_UNLIKELY(!player)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!player->mpv)) { return LDG_ERR_NOT_INIT; }
+
+    const char *cmd[] = { "set", "vid", on ? "auto" : "no", 0x0 };
+    int ret = mpv_command(player->mpv, cmd);
+    if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_LOAD; }
+
+    return LDG_ERR_AOK;
+}
+
+// audio only; ytdl-format only matters for loads that fall back to the hook
+uint32_t yt_player_video_set(yt_player_t *player, uint8_t on)
+{
+    uint32_t ret = player_vid_set(player, on);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return ret; }
+
+    int set_ret = mpv_set_property_string(player->mpv, "ytdl-format", on ? "" : "bestaudio/best");
+    if (LDG_UNLIKELY(set_ret < 0)) { return YT_ERR_PLAYER_LOAD; }
+
+    return LDG_ERR_AOK;
+}
+
+// the video track off while nothing shows it; turned back on, mpv's own refresh seek brings the picture back at the
+// current position without moving the audio
+uint32_t yt_player_decode_set(yt_player_t *player, uint8_t on)
+{
+    return player_vid_set(player, on);
+}
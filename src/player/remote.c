@@ -0,0 +1,345 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <syslog.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/core/err.h>
+#include <yeetee/player/frame.h>
+#include <yeetee/player/output.h>
+#include <yeetee/player/remote.h>
+
+#define YT_REMOTE_HEAD_MAX 256
+#define YT_REMOTE_CHUNK_HEAD_MAX 32
+#define YT_REMOTE_CHUNK_TERM_LEN 2
+#define YT_REMOTE_EWMA_SHIFT 3
+
+static uint64_t remote_now_ns(void)
+{
+    struct timespec ts = LDG_STRUCT_ZERO_INIT;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * LDG_NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t remote_buff_reserve(void **buff, size_t *cap, size_t need)
+{
+    if (need <= *cap) { return LDG_ERR_AOK; }
+
+    void *grown = realloc(*buff, need);
+    if (LDG_UNLIKELY(!grown)) { return LDG_ERR_ALLOC_NULL; }
+
+    *buff = grown;
+    *cap = need;
+
+    return LDG_ERR_AOK;
+}
+
+// compress, encode and frame one job as chunked direct transmission into out_buff; returns its length, 0 on failure
+size_t yt_remote_job_encode(yt_remote_t *remote, const yt_remote_job_t *job)
+{
+    if (LDG_UNLIKELY(!remote)) { return 0; }
+
+    if (LDG_UNLIKELY(!job)) { return 0; }
+
+    // a delta needs the base image on the terminal; anything else goes out whole
+    uint8_t delta = job->delta && remote->shown_id != 0;
+    uint32_t y0 = delta ? job->dirty_y : 0;
+    uint32_t rows = delta ? job->dirty_rows : job->pixel_h;
+    const uint8_t *src = job->pixels + (size_t)y0 * job->stride;
+    size_t raw_len = (size_t)rows * job->stride;
+
+    size_t z_need = compressBound((uLong)raw_len);
+    if (LDG_UNLIKELY(remote_buff_reserve((void **)&remote->z_buff, &remote->z_cap, z_need) != LDG_ERR_AOK)) { return 0; }
+
+    uLongf z_len = (uLongf)remote->z_cap;
+    int zret = compress2(remote->z_buff, &z_len, src, (uLong)raw_len, Z_BEST_SPEED);
+    if (LDG_UNLIKELY(zret != Z_OK))
+    {
+        syslog(LOG_ERR, "remote_job_encode; compress failed; ret: %d", zret);
+        return 0;
+    }
+
+    size_t b64_need = YT_FRAME_B64_LEN((size_t)z_len) + LDG_STR_TERM_SIZE;
+    if (LDG_UNLIKELY(remote_buff_reserve((void **)&remote->b64_buff, &remote->b64_cap, b64_need) != LDG_ERR_AOK)) { return 0; }
+
+    size_t b64_len = yt_frame_b64_encode(remote->z_buff, (size_t)z_len, remote->b64_buff, remote->b64_cap);
+    if (LDG_UNLIKELY(b64_len == 0)) { return 0; }
+
+    size_t chunk_cunt = (b64_len + YT_REMOTE_CHUNK_MAX - 1) / YT_REMOTE_CHUNK_MAX;
+    size_t out_need = b64_len + chunk_cunt * (YT_REMOTE_CHUNK_HEAD_MAX + YT_REMOTE_CHUNK_TERM_LEN) + YT_REMOTE_HEAD_MAX * 2;
+    if (LDG_UNLIKELY(remote_buff_reserve((void **)&remote->out_buff, &remote->out_cap, out_need) != LDG_ERR_AOK)) { return 0; }
+
+    char *out = remote->out_buff;
+    size_t o = 0;
+    uint32_t kitty_fmt = yt_frame_fmt_kitty_get(job->fmt);
+    uint32_t more = (chunk_cunt > 1);
+
+    // head
+    int head_len = 0;
+    if (delta) { head_len = snprintf(out, YT_REMOTE_HEAD_MAX, "\x1b_Ga=f,r=1,X=1,q=2,f=%u,x=0,y=%u,s=%u,v=%u,i=%u,o=z,m=%u;", kitty_fmt, y0, job->pixel_w, rows, remote->shown_id, more); }
+    else { head_len = snprintf(out, YT_REMOTE_HEAD_MAX, "\x1b[%u;%uH""\x1b_Ga=T,q=2,f=%u,s=%u,v=%u,i=%u,o=z,c=%u,r=%u,X=%u,Y=%u,m=%u;", job->cur_y, job->cur_x, kitty_fmt, job->pixel_w, job->pixel_h, job->kitty_id, job->place_cols, job->place_rows, job->place_px_x, job->place_px_y, more); }
+
+    if (LDG_UNLIKELY(head_len < 0 || head_len >= YT_REMOTE_HEAD_MAX)) { return 0; }
+
+    o += (size_t)head_len;
+
+    // chunks; every one but the last is a multiple of 4 so each decodes on its own
+    size_t off = 0;
+    size_t c = 0;
+    for (; c < chunk_cunt; c++)
+    {
+        size_t len = (b64_len - off < YT_REMOTE_CHUNK_MAX) ? b64_len - off : YT_REMOTE_CHUNK_MAX;
+
+        // kitty reads a continuation without a=f as a plain transmit, and without q=2 its reply lands on our stdin
+        uint32_t chunk_more = (c + 1 < chunk_cunt) ? 1u : 0u;
+        if (c > 0 && delta) { o += (size_t)snprintf(out + o, YT_REMOTE_CHUNK_HEAD_MAX, "\x1b_Ga=f,q=2,m=%u;", chunk_more); }
+        else if (c > 0) { o += (size_t)snprintf(out + o, YT_REMOTE_CHUNK_HEAD_MAX, "\x1b_Gq=2,m=%u;", chunk_more); }
+
+        memcpy(out + o, remote->b64_buff + off, len);
+        o += len;
+        out[o++] = '\x1b';
+        out[o++] = '\\';
+        off += len;
+    }
+
+    // tail
+    int tail_len = 0;
+    if (!delta && remote->shown_id != 0 && remote->shown_id != job->kitty_id) { tail_len = snprintf(out + o, YT_REMOTE_HEAD_MAX, "\x1b_Ga=d,d=I,i=%u,q=2;\x1b\\", remote->shown_id); }
+
+    o += (size_t)tail_len;
+
+    return o;
+}
+
+// returns bytes written, 0 on failure
+static size_t remote_job_send(yt_remote_t *remote, const yt_remote_job_t *job)
+{
+    size_t o = yt_remote_job_encode(remote, job);
+    if (LDG_UNLIKELY(o == 0)) { return 0; }
+
+    uint8_t delta = job->delta && remote->shown_id != 0;
+
+    // one frame queued behind the one on the wire; a slow link parks the stage here and the mailbox drops the rest
+    yt_output_video_wait(remote->output);
+
+    struct iovec iov[1] = { { remote->out_buff, o } };
+    if (LDG_UNLIKELY(yt_output_video_post(remote->output, iov, 1) != LDG_ERR_AOK))
+    {
+        // the next job goes out whole
+        remote->shown_id = 0;
+        return 0;
+    }
+
+    if (!delta) { remote->shown_id = job->kitty_id; }
+
+    return o;
+}
+
+static void* remote_stage_loop(void *arg)
+{
+    yt_remote_t *remote = (yt_remote_t *)arg;
+
+    pthread_mutex_lock(&remote->mut);
+    while (remote->running)
+    {
+        if (!remote->job_ready)
+        {
+            pthread_cond_wait(&remote->cond, &remote->mut);
+            continue;
+        }
+
+        yt_remote_job_t job = remote->job;
+        remote->job_ready = 0;
+        remote->busy = 1;
+        pthread_mutex_unlock(&remote->mut);
+
+        uint64_t start_ns = remote_now_ns();
+        size_t sent = remote_job_send(remote, &job);
+        uint64_t cost_ns = remote_now_ns() - start_ns;
+
+        pthread_mutex_lock(&remote->mut);
+        remote->busy = 0;
+        remote->done_mask |= 1u << job.slot;
+        remote->bytes += sent;
+        yt_hist_record(&remote->stage_hist, cost_ns);
+        if (sent != 0 && job.origin_ns != 0) { yt_hist_record(&remote->e2e_hist, start_ns + cost_ns - job.origin_ns); }
+
+        if (remote->stage_ns_avg == 0) { remote->stage_ns_avg = cost_ns; }
+        else { remote->stage_ns_avg = (uint64_t)((int64_t)remote->stage_ns_avg + (((int64_t)cost_ns - (int64_t)remote->stage_ns_avg) >> YT_REMOTE_EWMA_SHIFT)); }
+
+        pthread_cond_broadcast(&remote->cond);
+    }
+
+    pthread_mutex_unlock(&remote->mut);
+
+    return 0x0;
+}
+
+uint32_t yt_remote_init(yt_remote_t *remote, yt_output_t *output)
+{
+    if (LDG_UNLIKELY(!remote)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!output)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    memset(remote, 0, sizeof(*remote));
+    remote->output = output;
+
+    pthread_mutex_init(&remote->mut, 0x0);
+    pthread_cond_init(&remote->cond, 0x0);
+
+    remote->running = 1;
+    int pret = pthread_create(&remote->stage_thread, 0x0, remote_stage_loop, remote);
+    if (LDG_UNLIKELY(pret != 0))
+    {
+        syslog(LOG_ERR, "remote_init; pthread_create failed; ret: %d", pret);
+        remote->running = 0;
+        pthread_cond_destroy(&remote->cond);
+        pthread_mutex_destroy(&remote->mut);
+        return YT_ERR_PLAYER_RENDER_INIT;
+    }
+
+    syslog(LOG_INFO, "remote_init; chunk: %u; b64: %s", YT_REMOTE_CHUNK_MAX, yt_frame_b64_impl_get());
+
+    return LDG_ERR_AOK;
+}
+
+void yt_remote_shutdown(yt_remote_t *remote)
+{
+    if (LDG_UNLIKELY(!remote)) { return; }
+
+    if (remote->running)
+    {
+        pthread_mutex_lock(&remote->mut);
+        remote->running = 0;
+        pthread_cond_broadcast(&remote->cond);
+        pthread_mutex_unlock(&remote->mut);
+
+        int join_ret = pthread_join(remote->stage_thread, 0x0);
+        if (LDG_UNLIKELY(join_ret != 0)) { syslog(LOG_ERR, "remote_shutdown; pthread_join failed; ret: %d", join_ret); }
+
+        pthread_cond_destroy(&remote->cond);
+        pthread_mutex_destroy(&remote->mut);
+    }
+
+    free(remote->z_buff);
+    free(remote->b64_buff);
+    free(remote->out_buff);
+    remote->z_buff = 0x0;
+    remote->b64_buff = 0x0;
+    remote->out_buff = 0x0;
+}
+
+// latest wins; a job still waiting is superseded and its slot handed back as done
+uint32_t yt_remote_post(yt_remote_t *remote, const yt_remote_job_t *job)
+{
+    if (LDG_UNLIKELY(!remote)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!job)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    pthread_mutex_lock(&remote->mut);
+    if (remote->job_ready) { remote->done_mask |= 1u << remote->job.slot; }
+
+    remote->job = *job;
+    remote->job_ready = 1;
+    pthread_cond_broadcast(&remote->cond);
+    pthread_mutex_unlock(&remote->mut);
+
+    return LDG_ERR_AOK;
+}
+
+uint32_t yt_remote_reclaim(yt_remote_t *remote, yt_remote_job_t *job)
+{
+    if (LDG_UNLIKELY(!remote)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!job)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    uint32_t ret = LDG_ERR_EMPTY;
+
+    pthread_mutex_lock(&remote->mut);
+    if (remote->job_ready)
+    {
+        *job = remote->job;
+        remote->job_ready = 0;
+        ret = LDG_ERR_AOK;
+    }
+
+    pthread_mutex_unlock(&remote->mut);
+
+    return ret;
+}
+
+// blocks until the stage holds no pixels; the caller is about to move the slot mappings
+void yt_remote_drain(yt_remote_t *remote)
+{
+    if (LDG_UNLIKELY(!remote)) { return; }
+
+    pthread_mutex_lock(&remote->mut);
+    if (remote->job_ready)
+    {
+        remote->job_ready = 0;
+        remote->done_mask |= 1u << remote->job.slot;
+    }
+
+    while (remote->busy) { pthread_cond_wait(&remote->cond, &remote->mut); }
+
+    pthread_mutex_unlock(&remote->mut);
+}
+
+uint32_t yt_remote_done_take(yt_remote_t *remote)
+{
+    if (LDG_UNLIKELY(!remote)) { return 0; }
+
+    pthread_mutex_lock(&remote->mut);
+    uint32_t mask = remote->done_mask;
+    remote->done_mask = 0;
+    pthread_mutex_unlock(&remote->mut);
+
+    return mask;
+}
+
+// bytes written since the last call; stage cost is the running average
+uint64_t yt_remote_stats_take(yt_remote_t *remote, uint64_t *stage_ns)
+{
+    if (LDG_UNLIKELY(!remote)) { return 0; }
+
+    pthread_mutex_lock(&remote->mut);
+    uint64_t bytes = remote->bytes;
+    remote->bytes = 0;
+    if (stage_ns) { *stage_ns = remote->stage_ns_avg; }
+
+    pthread_mutex_unlock(&remote->mut);
+
+    return bytes;
+}
+
+uint32_t yt_remote_hist_get(yt_remote_t *remote, yt_hist_t *stage, yt_hist_t *e2e)
+{
+    if (LDG_UNLIKELY(!remote)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!stage)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!e2e)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    pthread_mutex_lock(&remote->mut);
+    memcpy(stage, &remote->stage_hist, sizeof(*stage));
+    memcpy(e2e, &remote->e2e_hist, sizeof(*e2e));
+    pthread_mutex_unlock(&remote->mut);
+
+    return LDG_ERR_AOK;
+}
+
+// shm and file transfer need the terminal on this host; over ssh only direct transmission reaches it
+uint8_t yt_remote_detect(void)
+{
+    const char *conn = getenv("SSH_CONNECTION");
+    if (conn && conn[0] != '\0') { return 1; }
+
+    const char *tty = getenv("SSH_TTY");
+    if (tty && tty[0] != '\0') { return 1; }
+
+    return 0;
+}
@@ -1,9 +1,19 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <dirent.h>
 #include <sys/mman.h>
+#include <sys/random.h>
+#include <sys/eventfd.h>
 #include <time.h>
 #include <syslog.h>
 #include <pthread.h>
@@ -13,70 +23,1210 @@
 #include <dangling/core/macros.h>
 #include <dangling/core/err.h>
 #include <yeetee/core/err.h>
+#include <yeetee/player/frame.h>
+#include <yeetee/player/hist.h>
+#include <yeetee/player/pages.h>
+#include <yeetee/player/output.h>
+#include <yeetee/player/remote.h>
+#include <yeetee/player/sixel.h>
+#include <yeetee/player/cells.h>
 #include <yeetee/player/render.h>
 
-#define YT_RENDER_BPP 4
-#define YT_RENDER_MAX_W 1920
-#define YT_RENDER_MAX_H 1080
-#define YT_RENDER_ALPHA_MASK 0xFF000000
-#define YT_RENDER_SHM_PATH_0 "/dev/shm/yeetee_frame_0"
-#define YT_RENDER_SHM_PATH_1 "/dev/shm/yeetee_frame_1"
-#define YT_RENDER_SHM_B64_0 "L2Rldi9zaG0veWVldGVlX2ZyYW1lXzA="
-#define YT_RENDER_SHM_B64_1 "L2Rldi9zaG0veWVldGVlX2ZyYW1lXzE="
-#define YT_RENDER_ESC_MAX 256
+#define YT_RENDER_SHM_DIR "/dev/shm"
+#define YT_RENDER_SHM_NAME_FMT "/yeetee-%u-%08x-%u"
+#define YT_RENDER_SHM_SCAN_FMT "yeetee-%u-%8x-%u%n"
+#define YT_RENDER_ID_SLOT_BITS 4
+#define YT_RENDER_FD_PATH_MAX 32
+#define YT_RENDER_TAIL_MAX 64
+#define YT_RENDER_ACK_POLL_MS 2
+#define YT_RENDER_ACK_TIMEOUT_NS (LDG_NS_PER_SEC / 2)
+#define YT_RENDER_DELTA_NONE YT_FRAME_BAND_NONE
+#define YT_RENDER_EWMA_SHIFT 3
+#define YT_RENDER_GOV_DOWN_WINDOWS 2
+#define YT_RENDER_GOV_UP_WINDOWS 4
+#define YT_RENDER_GOV_COOLDOWN_WINDOWS 2
+#define YT_RENDER_GOV_DEN 8
+#define YT_RENDER_ASPECT_DEN 1000
+#define YT_RENDER_ASPECT_MIN 100
+#define YT_RENDER_ASPECT_MAX 10000
+#define YT_RENDER_PACE_MAX_NS (LDG_NS_PER_SEC / 4)
 
+// governor steps in eighths of the base surface
+static const uint32_t render_gov_steps[] = { 8, 6, 4, 3, 2 };
+#define YT_RENDER_GOV_LEVELS (sizeof(render_gov_steps) / sizeof(render_gov_steps[0]))
+
+static uint64_t render_now_ns(void)
+{
+    struct timespec ts = LDG_STRUCT_ZERO_INIT;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * LDG_NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static void render_ewma(uint64_t *avg, uint64_t sample)
+{
+    if (*avg == 0) { *avg = sample; return; }
+
+    *avg = (uint64_t)((int64_t)*avg + (((int64_t)sample - (int64_t)*avg) >> YT_RENDER_EWMA_SHIFT));
+}
+
+// mpv core / vo thread; only signals and stamps, the render thread asks mpv what changed
 static void render_update_cb(void *arg)
 {
-    yt_render_t *render = (yt_render_t *)arg;
-    render->frame_ready = 1;
+    yt_render_t *render = (yt_render_t *)arg;
+    render->update_ns = render_now_ns();
+
+    uint64_t one = 1;
+    ssize_t wr = write((int)render->wake_fd, &one, sizeof(one));
+    (void)wr;
+}
+
+// ring
+static void render_ring_close(yt_render_t *render)
+{
+    uint32_t b = 0;
+    for (; b < render->slot_cunt; b++)
+    {
+        yt_render_slot_t *slot = &render->slots[b];
+
+        if (slot->map)
+        {
+            munmap(slot->map, render->shm_size);
+            slot->map = 0x0;
+        }
+
+        if (slot->fd != UINT32_MAX)
+        {
+            close((int)slot->fd);
+            slot->fd = UINT32_MAX;
+        }
+
+        // the terminal unlinks every name it has read; only unread ones are left
+        if (slot->path[0] != '\0' && unlink(slot->path) < 0 && errno != ENOENT) { syslog(LOG_ERR, "render_ring_close; shm unlink failed; idx: %u", b); }
+
+        slot->state = YT_RENDER_SLOT_FREE;
+    }
+}
+
+// names left behind by instances that died with frames in flight; the backing memory went with them
+static void render_shm_reap(void)
+{
+    DIR *dir = opendir(YT_RENDER_SHM_DIR);
+    if (LDG_UNLIKELY(!dir)) { return; }
+
+    uint32_t self = (uint32_t)getpid();
+    uint32_t reaped = 0;
+    struct dirent *ent = 0x0;
+    while ((ent = readdir(dir)) != 0x0)
+    {
+        uint32_t pid = 0;
+        uint32_t inst = 0;
+        uint32_t slot = 0;
+        int end = 0;
+        if (sscanf(ent->d_name, YT_RENDER_SHM_SCAN_FMT, &pid, &inst, &slot, &end) != 3 || ent->d_name[end] != '\0') { continue; }
+
+        if (pid == self || pid == 0) { continue; }
+
+        if (kill((pid_t)pid, 0) == 0 || errno != ESRCH) { continue; }
+
+        if (unlinkat(dirfd(dir), ent->d_name, 0) == 0) { reaped++; }
+    }
+
+    closedir(dir);
+
+    if (reaped > 0) { syslog(LOG_INFO, "render_shm_reap; stale objects removed; cunt: %u", reaped); }
+}
+
+// all or nothing; a partly reserved pool falls back to tmpfs for every slot
+static uint32_t render_ring_open_hugetlb(yt_render_t *render)
+{
+    size_t size = yt_pages_huge_round(yt_pages_stride_align((size_t)YT_RENDER_MAX_W * YT_FRAME_BPP_MAX) * YT_RENDER_MAX_H);
+
+    uint32_t b = 0;
+    for (; b < render->slot_cunt; b++)
+    {
+        yt_render_slot_t *slot = &render->slots[b];
+
+        uint32_t fd = UINT32_MAX;
+        void *map = MAP_FAILED;
+        if (yt_pages_hugetlb_open(size, &fd) == LDG_ERR_AOK) { map = mmap(0x0, size, PROT_READ | PROT_WRITE, MAP_SHARED, (int)fd, 0); }
+
+        if (map == MAP_FAILED)
+        {
+            if (fd != UINT32_MAX) { close((int)fd); }
+
+            uint32_t c = 0;
+            for (; c < b; c++)
+            {
+                munmap(render->slots[c].map, size);
+                close((int)render->slots[c].fd);
+                render->slots[c].map = 0x0;
+                render->slots[c].fd = UINT32_MAX;
+            }
+
+            return YT_ERR_PLAYER_RENDER_INIT;
+        }
+
+        slot->fd = fd;
+        slot->map = (uint8_t *)map;
+    }
+
+    render->shm_size = size;
+    render->pages = YT_PAGES_KIND_HUGETLB;
+
+    return LDG_ERR_AOK;
+}
+
+// slots are unnamed tmpfs files; a per-instance shm name is linked in per frame and kitty's t=s unlinks it once read
+static uint32_t render_ring_open(yt_render_t *render, uint32_t depth)
+{
+    render->slot_cunt = depth;
+    render->slot_next = 0;
+
+    uint32_t b = 0;
+    for (; b < depth; b++)
+    {
+        yt_render_slot_t *slot = &render->slots[b];
+        slot->fd = UINT32_MAX;
+        slot->kitty_id = render->id_base | (b + 1);
+        slot->state = YT_RENDER_SLOT_FREE;
+
+        char name[YT_RENDER_SHM_PATH_MAX] = LDG_ARR_ZERO_INIT;
+        snprintf(name, sizeof(name), YT_RENDER_SHM_NAME_FMT, (uint32_t)getpid(), render->inst_id, b);
+        snprintf(slot->path, sizeof(slot->path), "%s%s", YT_RENDER_SHM_DIR, name);
+
+        // kitty hands the payload straight to shm_open, which resolves it under /dev/shm
+        size_t b64_len = yt_frame_b64_encode((const uint8_t *)name, strlen(name), slot->name_b64, sizeof(slot->name_b64));
+        if (LDG_UNLIKELY(b64_len == 0)) { return YT_ERR_PLAYER_RENDER_INIT; }
+    }
+
+    // nothing outside this process opens the slots; explicit huge pages sized for the largest surface, so the ring never grows
+    if (render->backend != YT_RENDER_BACKEND_KITTY || render->remote)
+    {
+        uint32_t err = render_ring_open_hugetlb(render);
+        if (err == LDG_ERR_AOK) { return LDG_ERR_AOK; }
+    }
+
+    for (b = 0; b < depth; b++)
+    {
+        yt_render_slot_t *slot = &render->slots[b];
+
+        int fd = open(YT_RENDER_SHM_DIR, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+        if (LDG_UNLIKELY(fd < 0))
+        {
+            syslog(LOG_ERR, "render_ring_open; open shm failed; idx: %u; errno: %d", b, errno);
+            render_ring_close(render);
+            return YT_ERR_PLAYER_RENDER_INIT;
+        }
+
+        slot->fd = (uint32_t)fd;
+
+        int ft = ftruncate(fd, (off_t)render->shm_size);
+        if (LDG_UNLIKELY(ft < 0))
+        {
+            syslog(LOG_ERR, "render_ring_open; ftruncate shm failed; idx: %u", b);
+            render_ring_close(render);
+            return YT_ERR_PLAYER_RENDER_INIT;
+        }
+
+        slot->map = (uint8_t *)mmap(0x0, render->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (LDG_UNLIKELY(slot->map == MAP_FAILED))
+        {
+            syslog(LOG_ERR, "render_ring_open; mmap shm failed; idx: %u", b);
+            slot->map = 0x0;
+            render_ring_close(render);
+            return YT_ERR_PLAYER_RENDER_INIT;
+        }
+
+        // the vma keeps the advice across mremap, so a grown ring stays eligible
+        render->pages = yt_pages_advise(slot->map, render->shm_size, 1);
+    }
+
+    return LDG_ERR_AOK;
+}
+
+static uint32_t render_slot_publish(yt_render_slot_t *slot)
+{
+    char fd_path[YT_RENDER_FD_PATH_MAX] = LDG_ARR_ZERO_INIT;
+    snprintf(fd_path, sizeof(fd_path), "/proc/self/fd/%u", slot->fd);
+
+    int ret = linkat(AT_FDCWD, fd_path, AT_FDCWD, slot->path, AT_SYMLINK_FOLLOW);
+    if (ret < 0 && errno == EEXIST)
+    {
+        unlink(slot->path);
+        ret = linkat(AT_FDCWD, fd_path, AT_FDCWD, slot->path, AT_SYMLINK_FOLLOW);
+    }
+
+    if (LDG_UNLIKELY(ret < 0)) { return YT_ERR_PLAYER_RENDER; }
+
+    return LDG_ERR_AOK;
+}
+
+// render thread only, like every mpv_render_* call; the stage counts its swaps and leaves them to render_swap_flush
+// once a swap has been reported mpv's vo waits for one per rendered frame; frames that never reach the terminal count too
+static void render_swap_report(yt_render_t *render)
+{
+    if (render->pace) { mpv_render_context_report_swap(render->ctx); }
+}
+
+// swaps the stage presented since the last look, reported before mpv is asked for anything else
+static void render_swap_flush(yt_render_t *render)
+{
+    if (!render->tx_on) { return; }
+
+    pthread_mutex_lock(&render->tx_mut);
+    uint32_t swaps = render->tx_swap_cunt;
+    render->tx_swap_cunt = 0;
+    pthread_mutex_unlock(&render->tx_mut);
+
+    for (; swaps > 0; swaps--) { render_swap_report(render); }
+}
+
+// pts of the next frame moved onto our clock; 0 when mpv has none, a redraw or a paused frame goes out at once
+static uint64_t render_target_get(yt_render_t *render)
+{
+    mpv_render_frame_info info = LDG_STRUCT_ZERO_INIT;
+    mpv_render_param param = { MPV_RENDER_PARAM_NEXT_FRAME_INFO, &info };
+    if (mpv_render_context_get_info(render->ctx, param) < 0) { return 0; }
+
+    if (!(info.flags & MPV_RENDER_FRAME_INFO_PRESENT) || info.target_time <= 0) { return 0; }
+
+    // both clocks are monotonic, just not the same base; sampled back to back the skew is a few us
+    int64_t skew_ns = (int64_t)render_now_ns() - mpv_get_time_us(render->mpv) * 1000;
+    int64_t target_ns = info.target_time * 1000 + skew_ns;
+
+    return (target_ns > 0) ? (uint64_t)target_ns : 0;
+}
+
+// damage the terminal has not seen yet; a superseded remote job leaves its band behind
+static void render_carry_add(yt_render_t *render, uint8_t full, uint32_t y0, uint32_t rows)
+{
+    if (full) { render->carry_full = 1; }
+
+    if (!render->carry)
+    {
+        render->carry_y0 = y0;
+        render->carry_y1 = y0 + rows;
+        render->carry = 1;
+        return;
+    }
+
+    if (y0 < render->carry_y0) { render->carry_y0 = y0; }
+
+    if (y0 + rows > render->carry_y1) { render->carry_y1 = y0 + rows; }
+}
+
+// the stage reports back under its lock; slots it published go in flight, the rest come straight back
+static void render_tx_collect(yt_render_t *render)
+{
+    if (!render->tx_on) { return; }
+
+    pthread_mutex_lock(&render->tx_mut);
+    uint32_t done = render->tx_done_mask;
+    uint32_t sent = render->tx_sent_mask;
+    uint8_t fail = render->tx_fail;
+    render->tx_done_mask = 0;
+    render->tx_sent_mask = 0;
+    render->tx_fail = 0;
+    render->delta_cunt += render->tx_delta_cunt;
+    render->dup_cunt += render->tx_dup_cunt;
+    render->tx_delta_cunt = 0;
+    render->tx_dup_cunt = 0;
+    pthread_mutex_unlock(&render->tx_mut);
+
+    uint32_t b = 0;
+    for (; b < render->slot_cunt; b++)
+    {
+        if (done & (1u << b)) { render->slots[b].state = YT_RENDER_SLOT_FREE; }
+        else if (sent & (1u << b)) { render->slots[b].state = YT_RENDER_SLOT_INFLIGHT; }
+    }
+
+    // the terminal missed a frame; the next one goes out whole
+    if (fail) { render->tile_valid = 0; }
+}
+
+// latest wins; the render thread reclaims a waiting job before posting, so this only ever fills an empty mailbox
+static void render_tx_post(yt_render_t *render, const yt_render_job_t *job)
+{
+    pthread_mutex_lock(&render->tx_mut);
+    if (render->tx_ready) { render->tx_done_mask |= 1u << render->tx_job.slot; }
+
+    render->tx_job = *job;
+    render->tx_ready = 1;
+    pthread_cond_broadcast(&render->tx_cond);
+    pthread_mutex_unlock(&render->tx_mut);
+}
+
+static uint32_t render_tx_reclaim(yt_render_t *render, yt_render_job_t *job)
+{
+    uint32_t ret = LDG_ERR_EMPTY;
+
+    pthread_mutex_lock(&render->tx_mut);
+    if (render->tx_ready)
+    {
+        *job = render->tx_job;
+        render->tx_ready = 0;
+        ret = LDG_ERR_AOK;
+    }
+
+    pthread_mutex_unlock(&render->tx_mut);
+
+    return ret;
+}
+
+// blocks until the stage is idle; geometry, format and the slot mappings only change behind this
+static void render_tx_drain(yt_render_t *render)
+{
+    if (!render->tx_on) { return; }
+
+    pthread_mutex_lock(&render->tx_mut);
+    if (render->tx_ready)
+    {
+        render->tx_ready = 0;
+        render->tx_done_mask |= 1u << render->tx_job.slot;
+        render->tx_swap_cunt++;
+    }
+
+    // a frame held for its pts goes out now; it was drawn for the old geometry
+    render->tx_hurry = 1;
+    pthread_cond_broadcast(&render->tx_cond);
+    while (render->tx_busy) { pthread_cond_wait(&render->tx_cond, &render->tx_mut); }
+
+    render->tx_hurry = 0;
+    pthread_mutex_unlock(&render->tx_mut);
+
+    render_swap_flush(render);
+}
+
+// a job still waiting for either stage is superseded; its damage rides on the next frame and its slot is reused
+static uint32_t render_stage_reclaim(yt_render_t *render)
+{
+    if (render->remote)
+    {
+        yt_remote_job_t job = LDG_STRUCT_ZERO_INIT;
+        if (yt_remote_reclaim(&render->remote_stage, &job) != LDG_ERR_AOK) { return UINT32_MAX; }
+
+        render_carry_add(render, !job.delta, job.dirty_y, job.dirty_rows);
+        render->slots[job.slot].state = YT_RENDER_SLOT_FREE;
+        render->drop_cunt++;
+
+        return job.slot;
+    }
+
+    yt_render_job_t job = LDG_STRUCT_ZERO_INIT;
+    if (render_tx_reclaim(render, &job) != LDG_ERR_AOK) { return UINT32_MAX; }
+
+    render_carry_add(render, job.full, job.dirty_y, job.dirty_rows);
+    render->slots[job.slot].state = YT_RENDER_SLOT_FREE;
+    render->drop_cunt++;
+    render_swap_report(render);
+
+    return job.slot;
+}
+
+// reclaim slots the terminal has finished reading, then hand out the next free one
+static uint32_t render_slot_acquire(yt_render_t *render, uint64_t now_ns)
+{
+    render_tx_collect(render);
+
+    uint32_t oldest = UINT32_MAX;
+    uint64_t oldest_ns = UINT64_MAX;
+
+    uint32_t b = 0;
+    for (; b < render->slot_cunt; b++)
+    {
+        yt_render_slot_t *slot = &render->slots[b];
+        if (slot->state != YT_RENDER_SLOT_INFLIGHT) { continue; }
+
+        if (access(slot->path, F_OK) < 0 && errno == ENOENT)
+        {
+            slot->state = YT_RENDER_SLOT_FREE;
+            render->ack_seen = 1;
+            continue;
+        }
+
+        if (now_ns - slot->sent_ns >= YT_RENDER_ACK_TIMEOUT_NS)
+        {
+            if (!render->ack_seen && !render->ack_off)
+            {
+                syslog(LOG_WARNING, "%s", "render_slot_acquire; terminal never released a frame; flow control off");
+                render->ack_off = 1;
+            }
+
+            unlink(slot->path);
+            slot->state = YT_RENDER_SLOT_FREE;
+            continue;
+        }
+
+        if (slot->sent_ns < oldest_ns)
+        {
+            oldest_ns = slot->sent_ns;
+            oldest = b;
+        }
+    }
+
+    for (b = 0; b < render->slot_cunt; b++)
+    {
+        uint32_t idx = (render->slot_next + b) % render->slot_cunt;
+        if (render->slots[idx].state == YT_RENDER_SLOT_FREE) { return idx; }
+    }
+
+    uint32_t reclaimed = render_stage_reclaim(render);
+    if (reclaimed != UINT32_MAX) { return reclaimed; }
+
+    // without acks the ring degrades to plain round robin; overwrite the oldest
+    if (render->ack_off && oldest != UINT32_MAX)
+    {
+        unlink(render->slots[oldest].path);
+        render->slots[oldest].state = YT_RENDER_SLOT_FREE;
+        return oldest;
+    }
+
+    return UINT32_MAX;
+}
+
+// remote slots come back from the stage thread rather than from shm unlinks
+static uint32_t render_remote_acquire(yt_render_t *render)
+{
+    uint32_t done = yt_remote_done_take(&render->remote_stage);
+
+    uint32_t b = 0;
+    for (; b < render->slot_cunt; b++)
+    {
+        if (done & (1u << b)) { render->slots[b].state = YT_RENDER_SLOT_FREE; }
+    }
+
+    for (b = 0; b < render->slot_cunt; b++)
+    {
+        uint32_t idx = (render->slot_next + b) % render->slot_cunt;
+        if (render->slots[idx].state == YT_RENDER_SLOT_FREE) { return idx; }
+    }
+
+    // the stage holds every slot; the job still queued is superseded by this frame
+    return render_stage_reclaim(render);
+}
+
+static int render_esc_fmt(const yt_render_t *render, const yt_render_slot_t *slot, uint32_t w, uint32_t h, size_t frame_size, char *dst, size_t dst_len)
+{
+    return snprintf(dst, dst_len, "\x1b[%u;%uH""\x1b_Ga=T,q=2,f=%u,s=%u,v=%u,S=%zu,i=%u,t=s,c=%u,r=%u,X=%u,Y=%u;%s\x1b\\", render->video_abs_y + render->place_row + 1, render->video_abs_x + render->place_col + 1, yt_frame_fmt_kitty_get(render->fmt), w, h, frame_size, slot->kitty_id, render->place_cols, render->place_rows, render->place_px_x, render->place_px_y, slot->name_b64);
+}
+
+// every slot is measured before any is written, so a failure leaves the previous escapes intact
+static uint32_t render_esc_build(yt_render_t *render, uint32_t w, uint32_t h, size_t frame_size)
+{
+    uint32_t b = 0;
+    for (; b < render->slot_cunt; b++)
+    {
+        int esc_ret = render_esc_fmt(render, &render->slots[b], w, h, frame_size, 0x0, 0);
+        if (LDG_UNLIKELY(esc_ret < 0 || esc_ret >= (int)YT_RENDER_ESC_MAX))
+        {
+            syslog(LOG_ERR, "render_esc_build; esc_cmd overflow; idx: %u", b);
+            return YT_ERR_PLAYER_RENDER_INIT;
+        }
+    }
+
+    for (b = 0; b < render->slot_cunt; b++)
+    {
+        yt_render_slot_t *slot = &render->slots[b];
+
+        memset(slot->esc_cmd, 0, YT_RENDER_ESC_MAX);
+        slot->esc_len = (uint32_t)render_esc_fmt(render, slot, w, h, frame_size, slot->esc_cmd, YT_RENDER_ESC_MAX);
+    }
+
+    return LDG_ERR_AOK;
+}
+
+// fit the display aspect inside the cell box; placement snaps to whole cells and centres with pixel offsets
+static void render_fit(yt_render_t *render, uint32_t aspect_milli)
+{
+    uint64_t cell_w = render->cell_px_x;
+    uint64_t cell_h = render->cell_px_y;
+    uint64_t box_w = (uint64_t)render->video_cell_cols * cell_w;
+    uint64_t box_h = (uint64_t)render->video_cell_rows * cell_h;
+    uint64_t fit_w = box_w;
+    uint64_t fit_h = box_h;
+
+    if (aspect_milli != 0)
+    {
+        if (box_w * YT_RENDER_ASPECT_DEN > box_h * aspect_milli) { fit_w = box_h * aspect_milli / YT_RENDER_ASPECT_DEN; }
+        else { fit_h = box_w * YT_RENDER_ASPECT_DEN / aspect_milli; }
+    }
+
+    // kitty scales the image to c x r cells; rounding keeps the aspect error under half a cell
+    uint64_t cols = (fit_w + cell_w / 2) / cell_w;
+    uint64_t rows = (fit_h + cell_h / 2) / cell_h;
+    if (cols == 0) { cols = 1; }
+
+    if (rows == 0) { rows = 1; }
+
+    if (cols > render->video_cell_cols) { cols = render->video_cell_cols; }
+
+    if (rows > render->video_cell_rows) { rows = render->video_cell_rows; }
+
+    uint64_t off_x = (box_w - cols * cell_w) / 2;
+    uint64_t off_y = (box_h - rows * cell_h) / 2;
+    render->place_cols = (uint32_t)cols;
+    render->place_rows = (uint32_t)rows;
+    render->place_col = (uint32_t)(off_x / cell_w);
+    render->place_row = (uint32_t)(off_y / cell_h);
+    render->place_px_x = (uint32_t)(off_x % cell_w);
+    render->place_px_y = (uint32_t)(off_y % cell_h);
+
+    if (fit_w == 0) { fit_w = 1; }
+
+    if (fit_h == 0) { fit_h = 1; }
+
+    if (fit_w > YT_RENDER_MAX_W || fit_h > YT_RENDER_MAX_H)
+    {
+        if (fit_w * YT_RENDER_MAX_H > fit_h * YT_RENDER_MAX_W)
+        {
+            fit_h = (fit_h * YT_RENDER_MAX_W) / fit_w;
+            fit_w = YT_RENDER_MAX_W;
+        }
+        else
+        {
+            fit_w = (fit_w * YT_RENDER_MAX_H) / fit_h;
+            fit_h = YT_RENDER_MAX_H;
+        }
+    }
+
+    // sixel and cells are drawn pixel for pixel; only kitty scales the image onto the placement
+    if (render->backend == YT_RENDER_BACKEND_SIXEL)
+    {
+        fit_w = (cols * cell_w > YT_RENDER_MAX_W) ? YT_RENDER_MAX_W : cols * cell_w;
+        fit_h = (rows * cell_h > YT_RENDER_MAX_H) ? YT_RENDER_MAX_H : rows * cell_h;
+    }
+    else if (render->backend == YT_RENDER_BACKEND_CELLS)
+    {
+        fit_w = cols;
+        fit_h = rows * 2;
+    }
+
+    render->base_w = (uint32_t)fit_w;
+    render->base_h = (uint32_t)fit_h;
+    render->aspect_milli = aspect_milli;
+}
+
+// kitty reads rows back to back and has no stride key; only the text backends can take padded rows
+static size_t render_stride_get(const yt_render_t *render, uint32_t w, uint32_t bpp)
+{
+    size_t stride = (size_t)w * bpp;
+    if (render->backend == YT_RENDER_BACKEND_KITTY) { return stride; }
+
+    return yt_pages_stride_align(stride);
+}
+
+static void render_fmt_set(yt_render_t *render, yt_frame_fmt_t fmt)
+{
+    render->fmt = fmt;
+    render->stride = render_stride_get(render, render->pixel_w, yt_frame_fmt_bpp_get(fmt));
+    render->frame_size = render->stride * render->pixel_h;
+
+    // a format switch changes every byte; the next frame goes out whole
+    render->tile_valid = 0;
+}
+
+// hash the new frame in tiles against the last one sent; returns the first dirty pixel row, rows in *dirty_rows
+static uint32_t render_tiles_diff(yt_render_t *render, const uint8_t *frame, uint32_t *dirty_rows)
+{
+    uint32_t next = 1 - render->tile_cur;
+    uint64_t *prev_hash = render->tile_hash[render->tile_cur];
+    uint64_t *next_hash = render->tile_hash[next];
+
+    uint32_t tile_cunt = yt_frame_tiles_hash(frame, render->pixel_w, render->pixel_h, render->stride, yt_frame_fmt_bpp_get(render->fmt), next_hash, YT_RENDER_TILE_MAX);
+    render->tile_cur = next;
+
+    *dirty_rows = render->pixel_h;
+    if (!render->tile_valid || tile_cunt == 0)
+    {
+        render->tile_valid = (tile_cunt != 0);
+        return 0;
+    }
+
+    return yt_frame_tiles_band(prev_hash, next_hash, tile_cunt, render->pixel_w, render->pixel_h, dirty_rows);
+}
+
+// compression and the write happen on the remote stage; this only snapshots the placement and hands the slot over
+static void render_remote_submit(yt_render_t *render, const yt_render_job_t *rjob)
+{
+    yt_render_slot_t *slot = &render->slots[rjob->slot];
+
+    yt_remote_job_t job = LDG_STRUCT_ZERO_INIT;
+    job.pixels = slot->map;
+    job.stride = render->stride;
+    job.fmt = render->fmt;
+    job.slot = rjob->slot;
+    job.kitty_id = slot->kitty_id;
+    job.pixel_w = render->pixel_w;
+    job.pixel_h = render->pixel_h;
+    job.dirty_y = rjob->dirty_y;
+    job.dirty_rows = rjob->dirty_rows;
+    job.cur_y = render->video_abs_y + render->place_row + 1;
+    job.cur_x = render->video_abs_x + render->place_col + 1;
+    job.place_cols = render->place_cols;
+    job.place_rows = render->place_rows;
+    job.place_px_x = render->place_px_x;
+    job.place_px_y = render->place_px_y;
+    job.origin_ns = rjob->origin_ns;
+    job.delta = (render->shown_id != 0 && !rjob->full && (uint64_t)job.dirty_rows * 4 < (uint64_t)render->pixel_h * 3);
+
+    if (LDG_UNLIKELY(yt_remote_post(&render->remote_stage, &job) != LDG_ERR_AOK))
+    {
+        render->tile_valid = 0;
+        return;
+    }
+
+    slot->state = YT_RENDER_SLOT_INFLIGHT;
+    slot->sent_ns = rjob->now_ns;
+
+    if (job.delta) { render->delta_cunt++; }
+    else { render->shown_id = slot->kitty_id; }
+}
+
+typedef enum render_sent
+{
+    RENDER_SENT_FULL = 0,
+    RENDER_SENT_DELTA,
+    RENDER_SENT_NONE
+} render_sent_t;
+
+// transmit stage only; one frame queued behind the one in writev, the stage parks here and the mailbox drops the rest
+static uint32_t render_video_post(yt_render_t *render, const struct iovec *iov, uint32_t iov_cunt)
+{
+    yt_output_video_wait(render->output);
+    return yt_output_video_post(render->output, iov, iov_cunt);
+}
+
+// kitty; the slot is published under its shm name and stays in flight until the terminal unlinks it
+static uint32_t render_kitty_present(yt_render_t *render, const yt_render_job_t *job, render_sent_t *sent)
+{
+    yt_render_slot_t *slot = &render->slots[job->slot];
+
+    if (LDG_UNLIKELY(render_slot_publish(slot) != LDG_ERR_AOK))
+    {
+        syslog(LOG_ERR, "render_kitty_present; shm link failed; idx: %u; errno: %d", job->slot, errno);
+        return YT_ERR_PLAYER_RENDER;
+    }
+
+    // a band under three quarters of the frame is patched into the shown image in place
+    uint8_t delta = (render->shown_id != 0 && !job->full && (uint64_t)job->dirty_rows * 4 < (uint64_t)render->pixel_h * 3);
+    uint32_t err = LDG_ERR_AOK;
+
+    if (delta)
+    {
+        char delta_esc[YT_RENDER_ESC_MAX] = LDG_ARR_ZERO_INIT;
+        int delta_len = yt_frame_kitty_band_esc(delta_esc, sizeof(delta_esc), render->fmt, render->pixel_w, render->stride, job->dirty_y, job->dirty_rows, render->shown_id, slot->name_b64);
+
+        struct iovec iov[1] = { { delta_esc, (size_t)delta_len } };
+        err = render_video_post(render, iov, 1);
+    }
+    else
+    {
+        // the previous image goes in the same synchronized update so the swap is atomic
+        char tail[YT_RENDER_TAIL_MAX] = LDG_ARR_ZERO_INIT;
+        int tail_len = 0;
+        if (render->shown_id != 0 && render->shown_id != slot->kitty_id) { tail_len = snprintf(tail, sizeof(tail), "\x1b_Ga=d,d=I,i=%u,q=2;\x1b\\", render->shown_id); }
+
+        struct iovec iov[2] = { { slot->esc_cmd, slot->esc_len }, { tail, (size_t)tail_len } };
+        err = render_video_post(render, iov, 2);
+    }
+
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+    {
+        unlink(slot->path);
+        return err;
+    }
+
+    slot->sent_ns = render_now_ns();
+    *sent = delta ? RENDER_SENT_DELTA : RENDER_SENT_FULL;
+    if (!delta) { render->shown_id = slot->kitty_id; }
+
+    return LDG_ERR_AOK;
+}
+
+// sixel; the dirty band widens to whole cell rows so it can be drawn from a cursor position
+static uint32_t render_sixel_present(yt_render_t *render, const yt_render_job_t *job, render_sent_t *sent)
+{
+    uint32_t y0 = 0;
+    uint32_t y1 = render->pixel_h;
+    if (render->shown_id != 0 && !job->full)
+    {
+        y0 = (job->dirty_y / render->cell_px_y) * render->cell_px_y;
+        y1 = ((job->dirty_y + job->dirty_rows + render->cell_px_y - 1) / render->cell_px_y) * render->cell_px_y;
+        if (y1 > render->pixel_h) { y1 = render->pixel_h; }
+    }
+
+    uint32_t err = yt_sixel_encode(&render->sixel, render->slots[job->slot].map, render->pixel_w, render->stride, y0, y1 - y0);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    char cup[YT_RENDER_TAIL_MAX] = LDG_ARR_ZERO_INIT;
+    int cup_len = snprintf(cup, sizeof(cup), "\x1b[%u;%uH", render->video_abs_y + render->place_row + y0 / render->cell_px_y + 1, render->video_abs_x + render->place_col + 1);
+
+    struct iovec iov[2] = { { cup, (size_t)cup_len }, { render->sixel.out, render->sixel.out_len } };
+    err = render_video_post(render, iov, 2);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    *sent = (y1 - y0 < render->pixel_h) ? RENDER_SENT_DELTA : RENDER_SENT_FULL;
+    render->shown_id = render->slots[job->slot].kitty_id;
+
+    return LDG_ERR_AOK;
+}
+
+// half blocks; the encoder keeps its own per-cell history, the tile band only bounds the rows it scans
+static uint32_t render_cells_present(yt_render_t *render, const yt_render_job_t *job, render_sent_t *sent)
+{
+    uint32_t row0 = 0;
+    uint32_t rows = (render->pixel_h + 1) / 2;
+    if (render->shown_id != 0 && !job->full)
+    {
+        row0 = job->dirty_y / 2;
+        rows = (job->dirty_y + job->dirty_rows + 1) / 2 - row0;
+    }
+
+    uint32_t err = yt_cells_encode(&render->cells, render->slots[job->slot].map, render->pixel_w, render->pixel_h, render->stride, row0, rows, render->video_abs_y + render->place_row, render->video_abs_x + render->place_col);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    render->shown_id = render->slots[job->slot].kitty_id;
+    if (render->cells.out_len == 0)
+    {
+        *sent = RENDER_SENT_NONE;
+        return LDG_ERR_AOK;
+    }
+
+    struct iovec iov[1] = { { render->cells.out, render->cells.out_len } };
+    err = render_video_post(render, iov, 1);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+    {
+        yt_cells_invalidate(&render->cells);
+        return err;
+    }
+
+    *sent = (render->cells.emit_cunt < (uint64_t)render->pixel_w * rows) ? RENDER_SENT_DELTA : RENDER_SENT_FULL;
+
+    return LDG_ERR_AOK;
+}
+
+typedef uint32_t (*render_present_fn_t)(yt_render_t *render, const yt_render_job_t *job, render_sent_t *sent);
+
+typedef struct render_backend_ops
+{
+    const char *name;
+    render_present_fn_t present;
+    uint8_t held;
+} render_backend_ops_t;
+
+// indexed by yt_render_backend_t; a held slot stays in flight after the stage is done with it
+static const render_backend_ops_t render_backends[] = {
+    { "kitty", render_kitty_present, 1 },
+    { "sixel", render_sixel_present, 0 },
+    { "cells", render_cells_present, 0 }
+};
+
+// tx_mut held; sleeps until the frame's pts less what presenting usually costs, woken early by a drain or stop
+static void render_tx_pace(yt_render_t *render, uint64_t target_ns)
+{
+    uint64_t lead_ns = render->write_ns_avg;
+    if (target_ns <= lead_ns) { return; }
+
+    uint64_t wake_ns = target_ns - lead_ns;
+    uint64_t now_ns = render_now_ns();
+
+    // late already, or a pts so far out it can only be a seek or a clock jump
+    if (wake_ns <= now_ns || wake_ns - now_ns > YT_RENDER_PACE_MAX_NS) { return; }
+
+    struct timespec ts = LDG_STRUCT_ZERO_INIT;
+    ts.tv_sec = (time_t)(wake_ns / LDG_NS_PER_SEC);
+    ts.tv_nsec = (long)(wake_ns % LDG_NS_PER_SEC);
+
+    while (render->tx_running && !render->tx_hurry)
+    {
+        if (pthread_cond_timedwait(&render->tx_cond, &render->tx_mut, &ts) == ETIMEDOUT) { break; }
+    }
+}
+
+// transmit stage; encodes and queues one frame while the render thread is already drawing the next
+static void* render_tx_loop(void *arg)
+{
+    yt_render_t *render = (yt_render_t *)arg;
+    const render_backend_ops_t *ops = &render_backends[render->backend];
+
+    pthread_mutex_lock(&render->tx_mut);
+    while (render->tx_running)
+    {
+        if (!render->tx_ready)
+        {
+            pthread_cond_wait(&render->tx_cond, &render->tx_mut);
+            continue;
+        }
+
+        yt_render_job_t job = render->tx_job;
+        render->tx_ready = 0;
+        render->tx_busy = 1;
+        if (job.target_ns != 0) { render_tx_pace(render, job.target_ns); }
+
+        pthread_mutex_unlock(&render->tx_mut);
+
+        render_sent_t sent = RENDER_SENT_FULL;
+        uint64_t start_ns = render_now_ns();
+        uint32_t err = ops->present(render, &job, &sent);
+        uint64_t end_ns = render_now_ns();
+        uint64_t cost_ns = end_ns - start_ns;
+
+        pthread_mutex_lock(&render->stats_mut);
+        yt_hist_record(&render->stats.stage[YT_RENDER_STAGE_WRITE], cost_ns);
+        if (err == LDG_ERR_AOK && job.origin_ns != 0) { yt_hist_record(&render->stats.stage[YT_RENDER_STAGE_E2E], end_ns - job.origin_ns); }
+
+        pthread_mutex_unlock(&render->stats_mut);
+
+        pthread_mutex_lock(&render->tx_mut);
+        render->tx_busy = 0;
+        if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+        {
+            render->tx_fail = 1;
+            render->tx_done_mask |= 1u << job.slot;
+        }
+        else if (ops->held) { render->tx_sent_mask |= 1u << job.slot; }
+        else { render->tx_done_mask |= 1u << job.slot; }
+
+        if (sent == RENDER_SENT_DELTA) { render->tx_delta_cunt++; }
+        else if (sent == RENDER_SENT_NONE) { render->tx_dup_cunt++; }
+
+        render_ewma(&render->write_ns_avg, cost_ns);
+        pthread_cond_broadcast(&render->tx_cond);
+
+        // the render thread reports it; mpv takes one render call at a time
+        render->tx_swap_cunt++;
+        uint64_t one = 1;
+        ssize_t wr = write((int)render->wake_fd, &one, sizeof(one));
+        (void)wr;
+    }
+
+    pthread_mutex_unlock(&render->tx_mut);
+
+    return 0x0;
+}
+
+static void render_tx_stop(yt_render_t *render)
+{
+    if (!render->tx_on) { return; }
+
+    pthread_mutex_lock(&render->tx_mut);
+    render->tx_running = 0;
+    pthread_cond_broadcast(&render->tx_cond);
+    pthread_mutex_unlock(&render->tx_mut);
+
+    int join_ret = pthread_join(render->tx_thread, 0x0);
+    if (LDG_UNLIKELY(join_ret != 0)) { syslog(LOG_ERR, "render_tx_stop; pthread_join failed; ret: %d", join_ret); }
+}
+
+// render thread; the counters are mirrored here so a reader on the ui thread sees them consistent with the histograms
+static void render_stats_record(yt_render_t *render, uint64_t render_ns, uint64_t post_ns)
+{
+    pthread_mutex_lock(&render->stats_mut);
+    yt_hist_record(&render->stats.stage[YT_RENDER_STAGE_RENDER], render_ns);
+    yt_hist_record(&render->stats.stage[YT_RENDER_STAGE_POST], post_ns);
+    render->stats.frame_cunt++;
+    render->stats.drop_cunt = render->drop_cunt;
+    render->stats.dup_cunt = render->dup_cunt;
+    render->stats.delta_cunt = render->delta_cunt;
+    pthread_mutex_unlock(&render->stats_mut);
 }
 
 static void render_frame(yt_render_t *render)
 {
-    if (!render->frame_ready) { return; }
+    uint64_t now_ns = render_now_ns();
+
+    // terminal is behind; keep the frame pending until a slot comes back
+    uint32_t idx = render->remote ? render_remote_acquire(render) : render_slot_acquire(render, now_ns);
+    if (idx == UINT32_MAX) { return; }
 
-    render->frame_ready = 0;
+    render->frame_pending = 0;
 
-    uint8_t idx = render->back;
+    // asked before rendering; afterwards mpv already describes the frame after this one
+    uint64_t target_ns = render->pace ? render_target_get(render) : 0;
+
+    yt_render_slot_t *slot = &render->slots[idx];
     int skip_target = 0;
     int sw_size[2] = { (int)render->pixel_w, (int)render->pixel_h };
     size_t stride = render->stride;
 
     mpv_render_param params[] = {
         { MPV_RENDER_PARAM_SW_SIZE, &sw_size },
-        { MPV_RENDER_PARAM_SW_FORMAT, (void *)"rgb0" },
+        { MPV_RENDER_PARAM_SW_FORMAT, (void *)yt_frame_fmt_mpv_get(render->fmt) },
         { MPV_RENDER_PARAM_SW_STRIDE, &stride },
-        { MPV_RENDER_PARAM_SW_POINTER, render->shm_map[idx] },
+        { MPV_RENDER_PARAM_SW_POINTER, slot->map },
         { MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &skip_target },
         { MPV_RENDER_PARAM_INVALID, 0x0 }
     };
 
+    uint64_t render_start_ns = render_now_ns();
     int ret = mpv_render_context_render(render->ctx, params);
-    if (LDG_UNLIKELY(ret < 0)) { return; }
+    if (LDG_UNLIKELY(ret < 0))
+    {
+        if (render->fmt == YT_FRAME_FMT_RGBA32) { return; }
+
+        // packed rgb is optional in mpv's sw renderer; drop to rgb0 + alpha fixup for good
+        syslog(LOG_WARNING, "render_frame; %s rejected; ret: %d; falling back to rgba32 (%s)", yt_frame_fmt_mpv_get(render->fmt), ret, yt_frame_alpha_impl_get());
+        render_tx_drain(render);
+        render_fmt_set(render, YT_FRAME_FMT_RGBA32);
+        if (LDG_UNLIKELY(render_esc_build(render, render->pixel_w, render->pixel_h, render->frame_size) != LDG_ERR_AOK)) { return; }
 
-    uint32_t *pixels = (uint32_t *)render->shm_map[idx];
-    size_t pixel_cunt = render->shm_size / YT_RENDER_BPP;
-    size_t i = 0;
-    for (; i < pixel_cunt; i++) { pixels[i] |= YT_RENDER_ALPHA_MASK; }
+        stride = render->stride;
+        params[1].data = (void *)yt_frame_fmt_mpv_get(render->fmt);
+        ret = mpv_render_context_render(render->ctx, params);
+        if (LDG_UNLIKELY(ret < 0)) { return; }
+    }
 
-    pthread_mutex_lock(&render->stdout_mut);
-    ssize_t wr = write(STDOUT_FILENO, render->esc_cmd[idx], render->esc_len[idx]);
-    pthread_mutex_unlock(&render->stdout_mut);
-    if (LDG_UNLIKELY(wr < 0)) { return; }
+    uint64_t post_start_ns = render_now_ns();
+    if (render->fmt == YT_FRAME_FMT_RGBA32 && render->backend == YT_RENDER_BACKEND_KITTY) { yt_frame_alpha_fill(slot->map, render->frame_size); }
 
-    render->back = 1 - idx;
+    // capped or skipped for the remote budget; mpv's vo waits on every frame it offers, so it is drawn and let go
+    // before either stage sees it, and the tile hashes still describe what the terminal shows
+    if (render->frame_drop)
+    {
+        render->frame_drop = 0;
+        render_swap_report(render);
+        return;
+    }
 
     render->frame_cunt++;
-    struct timespec ts = LDG_STRUCT_ZERO_INIT;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    uint64_t now_ns = (uint64_t)ts.tv_sec * LDG_NS_PER_SEC + (uint64_t)ts.tv_nsec;
 
-    if (now_ns - render->fps_epoch_ns >= LDG_NS_PER_SEC)
+    uint32_t dirty_rows = 0;
+    uint32_t dirty_y = render_tiles_diff(render, slot->map, &dirty_rows);
+
+    uint64_t post_end_ns = render_now_ns();
+    render_ewma(&render->render_ns_avg, post_end_ns - render_start_ns);
+    render_stats_record(render, post_start_ns - render_start_ns, post_end_ns - post_start_ns);
+
+    // static frame; the terminal already shows it, the slot goes straight back to the ring
+    if (dirty_y == YT_RENDER_DELTA_NONE && !render->carry)
+    {
+        render->dup_cunt++;
+        render_swap_report(render);
+        return;
+    }
+
+    // latest wins; whatever still waits for a stage is dropped and its band folded into this one
+    render_stage_reclaim(render);
+    if (dirty_y != YT_RENDER_DELTA_NONE) { render_carry_add(render, dirty_rows == render->pixel_h, dirty_y, dirty_rows); }
+
+    uint32_t y0 = render->carry_y0;
+    uint32_t y1 = (render->carry_y1 > render->pixel_h) ? render->pixel_h : render->carry_y1;
+    if (y0 >= y1) { y0 = 0; y1 = render->pixel_h; }
+
+    yt_render_job_t job = LDG_STRUCT_ZERO_INIT;
+    job.now_ns = now_ns;
+    job.origin_ns = render->origin_ns;
+    job.target_ns = target_ns;
+    job.slot = idx;
+    job.dirty_y = y0;
+    job.dirty_rows = y1 - y0;
+    job.full = render->carry_full || job.dirty_rows == render->pixel_h;
+
+    render->carry = 0;
+    render->carry_full = 0;
+    render->slot_next = (idx + 1) % render->slot_cunt;
+
+    if (render->remote)
+    {
+        render_remote_submit(render, &job);
+        return;
+    }
+
+    slot->state = YT_RENDER_SLOT_STAGED;
+    render_tx_post(render, &job);
+}
+
+// tmpfs files grow under a reader; a terminal still reading an older frame keeps seeing its bytes
+static uint32_t render_ring_grow(yt_render_t *render, size_t size)
+{
+    // the stage reads straight from the mappings; nothing may be in flight while they move
+    if (render->remote) { yt_remote_drain(&render->remote_stage); }
+
+    uint32_t b = 0;
+    for (; b < render->slot_cunt; b++)
+    {
+        yt_render_slot_t *slot = &render->slots[b];
+
+        void *map = MAP_FAILED;
+        if (ftruncate((int)slot->fd, (off_t)size) == 0) { map = mremap(slot->map, render->shm_size, size, MREMAP_MAYMOVE); }
+
+        if (LDG_UNLIKELY(map == MAP_FAILED))
+        {
+            syslog(LOG_ERR, "render_ring_grow; grow failed; idx: %u; size: %zu; errno: %d", b, size, errno);
+
+            // shrinking a mapping in place cannot fail; keep every slot at the old capacity
+            uint32_t g = 0;
+            for (; g < b; g++) { render->slots[g].map = (uint8_t *)mremap(render->slots[g].map, size, render->shm_size, 0); }
+
+            return YT_ERR_PLAYER_RENDER;
+        }
+
+        slot->map = (uint8_t *)map;
+    }
+
+    render->shm_size = size;
+
+    return LDG_ERR_AOK;
+}
+
+// render thread only; buffers only ever grow, so a window drag settles without remapping on every step
+static uint32_t render_surface_resize(yt_render_t *render, uint32_t lvl)
+{
+    render_tx_drain(render);
+
+    uint32_t w = render->base_w * render_gov_steps[lvl] / YT_RENDER_GOV_DEN;
+    uint32_t h = render->base_h * render_gov_steps[lvl] / YT_RENDER_GOV_DEN;
+    if (LDG_UNLIKELY(w == 0 || h == 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    uint32_t prev_w = render->pixel_w;
+    uint32_t prev_h = render->pixel_h;
+
+    size_t need = yt_pages_huge_round(render_stride_get(render, w, YT_FRAME_BPP_MAX) * h);
+    if (need > render->shm_size)
+    {
+        uint32_t err = render_ring_grow(render, need);
+        if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+    }
+
+    // escapes first; nothing below can fail, so the surface, level and escapes always agree
+    size_t frame_size = render_stride_get(render, w, yt_frame_fmt_bpp_get(render->fmt)) * h;
+    uint32_t err = render_esc_build(render, w, h, frame_size);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    render->pixel_w = w;
+    render->pixel_h = h;
+    render->surface_wh = (w << 16) | h;
+    render_fmt_set(render, render->fmt);
+
+    // the placement may have moved without the cell grid changing size
+    if (render->backend == YT_RENDER_BACKEND_CELLS) { yt_cells_invalidate(&render->cells); }
+
+    render->gov_lvl = lvl;
+    syslog(LOG_INFO, "render_surface_resize; %ux%u -> %ux%u; lvl: %u; shm_size: %zu", prev_w, prev_h, w, h, lvl, render->shm_size);
+
+    return LDG_ERR_AOK;
+}
+
+// ui thread geometry; copied under the lock, applied on the render thread between frames
+static void render_geom_apply(yt_render_t *render)
+{
+    pthread_mutex_lock(&render->geom_mut);
+    yt_render_geom_t geom = render->geom_req;
+    render->geom_seen = render->geom_gen;
+    pthread_mutex_unlock(&render->geom_mut);
+
+    render->cell_px_x = geom.cell_px_x;
+    render->cell_px_y = geom.cell_px_y;
+    render->video_cell_cols = geom.cell_cols;
+    render->video_cell_rows = geom.cell_rows;
+    render->video_abs_y = geom.abs_y;
+    render->video_abs_x = geom.abs_x;
+}
+
+// once per second; step down after sustained overload, step up only when the larger surface still fits with margin
+static void render_gov_tick(yt_render_t *render)
+{
+    uint32_t offered = render->offer_cunt;
+    uint64_t drops = render->drop_cunt - render->gov_drop_mark;
+    render->offer_cunt = 0;
+    render->gov_drop_mark = render->drop_cunt;
+
+    // both stages run beside the render thread; remote output is bound by the link, not the cpu
+    uint64_t stage_ns = 0;
+    uint64_t bytes = render->remote ? yt_remote_stats_take(&render->remote_stage, &stage_ns) : 0;
+    if (render->tx_on)
+    {
+        pthread_mutex_lock(&render->tx_mut);
+        stage_ns = render->write_ns_avg;
+        pthread_mutex_unlock(&render->tx_mut);
+    }
+
+    if ((!render->gov_on && !render->remote) || offered == 0) { return; }
+
+    if (render->gov_cooldown > 0)
+    {
+        render->gov_cooldown--;
+        return;
+    }
+
+    uint64_t budget_ns = LDG_NS_PER_SEC / offered;
+    // pipelined; the slower stage sets the frame rate
+    uint64_t cost_ns = (stage_ns > render->render_ns_avg) ? stage_ns : render->render_ns_avg;
+
+    uint8_t behind = (cost_ns * 5 > budget_ns * 4) || (drops * 10 > offered) || (render->remote && bytes > render->remote_budget);
+
+    uint8_t headroom = 0;
+    if (render->remote_skip > 1 && drops == 0)
+    {
+        uint64_t skip = render->remote_skip;
+        headroom = (bytes * skip * 2 < render->remote_budget * (skip - 1)) && (cost_ns * skip * 2 < budget_ns * (skip - 1));
+    }
+    else if (render->gov_lvl > 0 && drops == 0)
+    {
+        uint64_t cur = render_gov_steps[render->gov_lvl];
+        uint64_t up = render_gov_steps[render->gov_lvl - 1];
+        headroom = (cost_ns * up * up * 2 < budget_ns * cur * cur);
+        if (render->remote) { headroom = headroom && (bytes * up * up * 2 < render->remote_budget * cur * cur); }
+    }
+
+    if (behind) { render->gov_bad++; render->gov_good = 0; }
+    else if (headroom) { render->gov_good++; render->gov_bad = 0; }
+    else { render->gov_good = 0; render->gov_bad = 0; }
+
+    // remote only; past the smallest surface the frame rate gives way, and comes back before the surface grows
+    uint32_t skip = render->remote_skip;
+    if (render->remote && render->gov_bad >= YT_RENDER_GOV_DOWN_WINDOWS && render->gov_lvl + 1 >= YT_RENDER_GOV_LEVELS && skip < YT_RENDER_SKIP_MAX) { skip++; }
+    else if (render->gov_good >= YT_RENDER_GOV_UP_WINDOWS && skip > 1) { skip--; }
+
+    if (skip != render->remote_skip)
+    {
+        syslog(LOG_INFO, "render_gov_tick; remote skip: %u -> %u; bytes: %lu; budget: %lu", render->remote_skip, skip, (unsigned long)bytes, (unsigned long)render->remote_budget);
+        render->remote_skip = skip;
+        render->gov_good = 0;
+        render->gov_bad = 0;
+        render->gov_cooldown = YT_RENDER_GOV_COOLDOWN_WINDOWS;
+        return;
+    }
+
+    uint32_t lvl = render->gov_lvl;
+    if (render->gov_bad >= YT_RENDER_GOV_DOWN_WINDOWS && lvl + 1 < YT_RENDER_GOV_LEVELS) { lvl++; }
+    else if (render->gov_good >= YT_RENDER_GOV_UP_WINDOWS && lvl > 0) { lvl--; }
+
+    if (lvl == render->gov_lvl) { return; }
+
+    syslog(LOG_INFO, "render_gov_tick; offered: %u; drops: %lu; render_ns: %lu; stage_ns: %lu", offered, (unsigned long)drops, (unsigned long)render->render_ns_avg, (unsigned long)stage_ns);
+    uint32_t err = render_surface_resize(render, lvl);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+    {
+        // still on the old surface, so its timings stand; wait out a cooldown before trying again
+        syslog(LOG_WARNING, "render_gov_tick; resize failed; lvl: %u; err: %u", lvl, err);
+        render->gov_cooldown = YT_RENDER_GOV_COOLDOWN_WINDOWS;
+        return;
+    }
+
+    // timings measured on the old surface say nothing about the new one; the stage is drained and idle here
+    render->render_ns_avg = 0;
+    if (render->tx_on)
     {
-        render->fps = render->frame_cunt;
-        render->frame_cunt = 0;
-        render->fps_epoch_ns = now_ns;
+        pthread_mutex_lock(&render->tx_mut);
+        render->write_ns_avg = 0;
+        pthread_mutex_unlock(&render->tx_mut);
     }
+    render->gov_good = 0;
+    render->gov_bad = 0;
+    render->gov_cooldown = YT_RENDER_GOV_COOLDOWN_WINDOWS;
+}
+
+static void render_stats_tick(yt_render_t *render)
+{
+    uint64_t now_ns = render_now_ns();
+    if (now_ns - render->fps_epoch_ns < LDG_NS_PER_SEC) { return; }
+
+    render->fps = render->frame_cunt;
+    render->frame_cunt = 0;
+    render->fps_epoch_ns = now_ns;
+
+    render_gov_tick(render);
 }
 
 static void* render_loop(void *arg)
@@ -85,17 +1235,85 @@ static void* render_loop(void *arg)
 
     while (render->running)
     {
-        render_frame(render);
+        // block until mpv signals, or poll briefly while a frame waits on a free slot
+        struct pollfd pfd = LDG_STRUCT_ZERO_INIT;
+        pfd.fd = (int)render->wake_fd;
+        pfd.events = POLLIN;
+
+        int pr = poll(&pfd, 1, render->frame_pending ? YT_RENDER_ACK_POLL_MS : -1);
+        if (LDG_UNLIKELY(pr < 0)) { continue; }
+
+        if (pr > 0)
+        {
+            uint64_t wakeups = 0;
+            ssize_t rd = read((int)render->wake_fd, &wakeups, sizeof(wakeups));
+            (void)rd;
+        }
+
+        if (!render->running) { break; }
 
-        struct timespec ts = LDG_STRUCT_ZERO_INIT;
-        ts.tv_nsec = 1000000;
-        nanosleep(&ts, 0x0);
+        render_swap_flush(render);
+
+        // geometry or aspect from the ui thread; refit the surface and redraw the current frame into it
+        uint32_t aspect_milli = render->aspect_req;
+        uint8_t geom_dirty = (render->geom_gen != render->geom_seen);
+        if (geom_dirty || aspect_milli != render->aspect_milli)
+        {
+            // the stage reads placement and cell geometry while it encodes
+            render_tx_drain(render);
+            if (geom_dirty) { render_geom_apply(render); }
+
+            render_fit(render, aspect_milli);
+            uint32_t err = render_surface_resize(render, render->gov_lvl);
+            if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { syslog(LOG_WARNING, "render_loop; resize failed; lvl: %u; err: %u", render->gov_lvl, err); }
+
+            render->frame_pending = 1;
+            render->frame_drop = 0;
+        }
+
+        if (pr > 0)
+        {
+            uint64_t flags = mpv_render_context_update(render->ctx);
+            // remote links over budget send every nth frame only; the rest are rendered and never posted
+            uint8_t capped = 0;
+            if ((flags & MPV_RENDER_UPDATE_FRAME) && render->remote_skip > 1) { capped = (++render->skip_phase % render->remote_skip) != 0; }
+
+            // the mark advances by whole intervals so a 30 fps source under a 10 fps cap keeps every third; paced frames
+            // are judged on their pts so the kept ones stay evenly spaced whatever the wakeup jitter
+            uint64_t frame_min_ns = render->frame_min_ns;
+            if ((flags & MPV_RENDER_UPDATE_FRAME) && !capped && frame_min_ns != 0)
+            {
+                uint64_t cap_ns = render->pace ? render_target_get(render) : 0;
+                if (cap_ns == 0) { cap_ns = render_now_ns(); }
+
+                uint64_t since_ns = cap_ns - render->cap_mark_ns;
+                if (since_ns < frame_min_ns) { capped = 1; }
+                else { render->cap_mark_ns = (since_ns < frame_min_ns * 2) ? render->cap_mark_ns + frame_min_ns : cap_ns; }
+            }
+
+            if (flags & MPV_RENDER_UPDATE_FRAME)
+            {
+                if (!capped) { render->offer_cunt++; }
+
+                // a newer frame replaces the one still waiting; a kept one is never shown unless this one takes its place
+                uint8_t kept_pending = render->frame_pending && !render->frame_drop;
+                if (kept_pending && !capped) { render->drop_cunt++; }
+
+                render->frame_drop = kept_pending ? 0 : capped;
+                render->frame_pending = 1;
+                render->origin_ns = render->update_ns;
+            }
+        }
+
+        if (render->frame_pending) { render_frame(render); }
+
+        render_stats_tick(render);
     }
 
     return 0x0;
 }
 
-uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *parent, uint32_t cell_rows, uint32_t cell_cols)
+uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *parent, uint32_t cell_rows, uint32_t cell_cols, const yt_render_opts_t *opts)
 {
     if (LDG_UNLIKELY(!render)) { return LDG_ERR_FUNC_ARG_NULL; }
 
@@ -103,9 +1321,21 @@ uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *pa
 
     if (LDG_UNLIKELY(!parent)) { return LDG_ERR_FUNC_ARG_NULL; }
 
+    if (LDG_UNLIKELY(!opts)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!opts->output)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(opts->ring_depth < YT_RENDER_RING_MIN || opts->ring_depth > YT_RENDER_RING_MAX)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    if (LDG_UNLIKELY(opts->backend > YT_RENDER_BACKEND_CELLS)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
     memset(render, 0, sizeof(*render));
-    render->shm_fd[0] = UINT32_MAX;
-    render->shm_fd[1] = UINT32_MAX;
+    render->wake_fd = UINT32_MAX;
+    render->mpv = mpv;
+    render->backend = opts->backend;
+    render->output = opts->output;
+    render->cap_base_ns = (opts->fps_cap != 0) ? LDG_NS_PER_SEC / opts->fps_cap : 0;
+    render->frame_min_ns = render->cap_base_ns;
 
     unsigned pix_y = 0;
     unsigned pix_x = 0;
@@ -123,69 +1353,52 @@ uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *pa
 
     uint32_t native_w = cell_cols * cell_px_x;
     uint32_t native_h = cell_rows * cell_px_y;
-    render->pixel_w = native_w;
-    render->pixel_h = native_h;
-
-    if (render->pixel_w > YT_RENDER_MAX_W || render->pixel_h > YT_RENDER_MAX_H)
-    {
-        if (render->pixel_w * YT_RENDER_MAX_H > render->pixel_h * YT_RENDER_MAX_W)
-        {
-            render->pixel_h = (render->pixel_h * YT_RENDER_MAX_W) / render->pixel_w;
-            render->pixel_w = YT_RENDER_MAX_W;
-        }
-        else
-        {
-            render->pixel_w = (render->pixel_w * YT_RENDER_MAX_H) / render->pixel_h;
-            render->pixel_h = YT_RENDER_MAX_H;
-        }
-    }
-
-    render->stride = (size_t)render->pixel_w * YT_RENDER_BPP;
-    render->shm_size = render->stride * render->pixel_h;
-
-    syslog(LOG_INFO, "render_init; native: %ux%u; scaled: %ux%u; stride: %zu; cell_px: %ux%u", native_w, native_h, render->pixel_w, render->pixel_h, render->stride, cell_px_x, cell_px_y);
-
-    // shm
-    const char *shm_paths[2] = { YT_RENDER_SHM_PATH_0, YT_RENDER_SHM_PATH_1 };
+    render->cell_px_x = cell_px_x;
+    render->cell_px_y = cell_px_y;
+    render->video_cell_cols = cell_cols;
+    render->video_cell_rows = cell_rows;
 
-    uint32_t b = 0;
-    for (; b < 2; b++)
-    {
-        int fd = open(shm_paths[b], O_RDWR | O_CREAT | O_TRUNC, 0600);
-        if (LDG_UNLIKELY(fd < 0))
-        {
-            syslog(LOG_ERR, "render_init; open shm failed; idx: %u", b);
-            if (b == 1) { munmap(render->shm_map[0], render->shm_size); render->shm_map[0] = 0x0; close((int)render->shm_fd[0]); render->shm_fd[0] = UINT32_MAX; }
+    // aspect unknown until mpv reports video-params; fill the box until then
+    render_fit(render, 0);
+    render->pixel_w = render->base_w;
+    render->pixel_h = render->base_h;
+    render->surface_wh = (render->pixel_w << 16) | render->pixel_h;
 
-            return YT_ERR_PLAYER_RENDER_INIT;
-        }
+    // shm sized for the widest format so an rgb24 -> rgba32 fallback never remaps
+    render->gov_on = opts->governor && render->backend == YT_RENDER_BACKEND_KITTY;
+    render->remote = opts->remote && render->backend == YT_RENDER_BACKEND_KITTY;
+    render->remote_budget = (opts->remote_budget != 0) ? opts->remote_budget : YT_REMOTE_DEFAULT_BUDGET;
+    render->remote_skip = 1;
+    // the remote stage keeps its own mailbox and pace; pts scheduling lives in the transmit stage
+    render->pace = opts->pace && !render->remote;
+    // the text backends quantize from rgb0; four byte pixels keep their colour kernels aligned
+    render_fmt_set(render, (render->backend == YT_RENDER_BACKEND_KITTY) ? opts->fmt : YT_FRAME_FMT_RGBA32);
+    render->shm_size = yt_pages_huge_round(render_stride_get(render, render->pixel_w, YT_FRAME_BPP_MAX) * render->pixel_h);
 
-        render->shm_fd[b] = (uint32_t)fd;
+    syslog(LOG_INFO, "render_init; native: %ux%u; scaled: %ux%u; fmt: %s; stride: %zu; cell_px: %ux%u", native_w, native_h, render->pixel_w, render->pixel_h, yt_frame_fmt_name_get(render->fmt), render->stride, cell_px_x, cell_px_y);
 
-        int ft = ftruncate((int)render->shm_fd[b], (off_t)render->shm_size);
-        if (LDG_UNLIKELY(ft < 0))
-        {
-            syslog(LOG_ERR, "render_init; ftruncate shm failed; idx: %u", b);
-            close((int)render->shm_fd[b]);
-            render->shm_fd[b] = UINT32_MAX;
-            if (b == 1) { munmap(render->shm_map[0], render->shm_size); render->shm_map[0] = 0x0; close((int)render->shm_fd[0]); render->shm_fd[0] = UINT32_MAX; }
+    // shm; names carry pid + a random instance id so concurrent instances never share a frame
+    uint32_t inst_id = 0;
+    if (getrandom(&inst_id, sizeof(inst_id), GRND_NONBLOCK) != (ssize_t)sizeof(inst_id)) { inst_id = (uint32_t)render_now_ns(); }
 
-            return YT_ERR_PLAYER_RENDER_INIT;
-        }
+    render->inst_id = inst_id;
+    render->id_base = ((uint32_t)getpid() & (UINT32_MAX >> YT_RENDER_ID_SLOT_BITS)) << YT_RENDER_ID_SLOT_BITS;
+    if (render->backend == YT_RENDER_BACKEND_KITTY && !render->remote) { render_shm_reap(); }
 
-        render->shm_map[b] = (uint8_t *)mmap(0x0, render->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, (int)render->shm_fd[b], 0);
-        if (LDG_UNLIKELY(render->shm_map[b] == MAP_FAILED))
-        {
-            syslog(LOG_ERR, "render_init; mmap shm failed; idx: %u", b);
-            render->shm_map[b] = 0x0;
-            close((int)render->shm_fd[b]);
-            render->shm_fd[b] = UINT32_MAX;
-            if (b == 1) { munmap(render->shm_map[0], render->shm_size); render->shm_map[0] = 0x0; close((int)render->shm_fd[0]); render->shm_fd[0] = UINT32_MAX; }
+    uint32_t err = render_ring_open(render, opts->ring_depth);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
 
-            return YT_ERR_PLAYER_RENDER_INIT;
-        }
+    // wake
+    int wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (LDG_UNLIKELY(wake_fd < 0))
+    {
+        syslog(LOG_ERR, "%s", "render_init; eventfd failed");
+        render_ring_close(render);
+        return YT_ERR_PLAYER_RENDER_INIT;
     }
 
+    render->wake_fd = (uint32_t)wake_fd;
+
     mpv_render_param params[] = {
         { MPV_RENDER_PARAM_API_TYPE, (void *)MPV_RENDER_API_TYPE_SW },
         { MPV_RENDER_PARAM_INVALID, 0x0 }
@@ -195,15 +1408,14 @@ uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *pa
     if (LDG_UNLIKELY(ret < 0))
     {
         syslog(LOG_ERR, "render_init; mpv_render_context_create failed; ret: %d", ret);
-        for (b = 0; b < 2; b++) { munmap(render->shm_map[b], render->shm_size); render->shm_map[b] = 0x0; close((int)render->shm_fd[b]); render->shm_fd[b] = UINT32_MAX; }
+        close((int)render->wake_fd);
+        render->wake_fd = UINT32_MAX;
+        render_ring_close(render);
         return YT_ERR_PLAYER_RENDER_INIT;
     }
 
     mpv_render_context_set_update_callback(render->ctx, render_update_cb, render);
 
-    render->video_cell_cols = cell_cols;
-    render->video_cell_rows = cell_rows;
-
     unsigned parent_rows = 0;
     unsigned parent_cols = 0;
     ncplane_dim_yx(parent, &parent_rows, &parent_cols);
@@ -221,7 +1433,9 @@ uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *pa
         syslog(LOG_ERR, "%s", "render_init; ncplane_create failed");
         mpv_render_context_free(render->ctx);
         render->ctx = 0x0;
-        for (b = 0; b < 2; b++) { munmap(render->shm_map[b], render->shm_size); render->shm_map[b] = 0x0; close((int)render->shm_fd[b]); render->shm_fd[b] = UINT32_MAX; }
+        close((int)render->wake_fd);
+        render->wake_fd = UINT32_MAX;
+        render_ring_close(render);
         return YT_ERR_PLAYER_RENDER_INIT;
     }
 
@@ -232,53 +1446,94 @@ uint32_t yt_render_init(yt_render_t *render, mpv_handle *mpv, struct ncplane *pa
     render->video_abs_x = (uint32_t)abs_x;
 
     // esc
-    const char *shm_b64[2] = { YT_RENDER_SHM_B64_0, YT_RENDER_SHM_B64_1 };
-    uint32_t kitty_id[2] = { 1, 2 };
-
-    for (b = 0; b < 2; b++)
+    if (LDG_UNLIKELY(render_esc_build(render, render->pixel_w, render->pixel_h, render->frame_size) != LDG_ERR_AOK))
     {
-        uint32_t other = 1 - b;
-        memset(render->esc_cmd[b], 0, YT_RENDER_ESC_MAX);
-        int esc_ret = snprintf(render->esc_cmd[b], YT_RENDER_ESC_MAX, "\x1b[?2026h""\x1b[%u;%uH""\x1b_Ga=T,q=2,f=32,s=%u,v=%u,i=%u,t=f,c=%u,r=%u;%s\x1b\\""\x1b_Ga=d,d=I,i=%u,q=2;\x1b\\""\x1b[?2026l", render->video_abs_y + 1, render->video_abs_x + 1, render->pixel_w, render->pixel_h, kitty_id[b], render->video_cell_cols, render->video_cell_rows, shm_b64[b], kitty_id[other]);
-        if (LDG_UNLIKELY(esc_ret < 0 || esc_ret >= (int)YT_RENDER_ESC_MAX))
-        {
-            syslog(LOG_ERR, "render_init; esc_cmd overflow; idx: %u", b);
-            mpv_render_context_free(render->ctx);
-            render->ctx = 0x0;
-            ncplane_destroy(render->video_plane);
-            render->video_plane = 0x0;
-            for (uint32_t c = 0; c < 2; c++) { munmap(render->shm_map[c], render->shm_size); render->shm_map[c] = 0x0; close((int)render->shm_fd[c]); render->shm_fd[c] = UINT32_MAX; }
-            return YT_ERR_PLAYER_RENDER_INIT;
-        }
-
-        render->esc_len[b] = (uint32_t)esc_ret;
+        mpv_render_context_free(render->ctx);
+        render->ctx = 0x0;
+        close((int)render->wake_fd);
+        render->wake_fd = UINT32_MAX;
+        ncplane_destroy(render->video_plane);
+        render->video_plane = 0x0;
+        render_ring_close(render);
+        return YT_ERR_PLAYER_RENDER_INIT;
     }
 
-    struct timespec init_ts = LDG_STRUCT_ZERO_INIT;
-    clock_gettime(CLOCK_MONOTONIC, &init_ts);
-    render->fps_epoch_ns = (uint64_t)init_ts.tv_sec * LDG_NS_PER_SEC + (uint64_t)init_ts.tv_nsec;
+    render->fps_epoch_ns = render_now_ns();
+
+    syslog(LOG_INFO, "render_init; backend: %s; video abs: %u,%u; cells: %ux%u; shm_size: %zu; pages: %s; ring: %u; esc_len: %u; tile hash: %s; pace: %u; fps cap: %u", render_backends[render->backend].name, render->video_abs_y, render->video_abs_x, render->video_cell_cols, render->video_cell_rows, render->shm_size, yt_pages_kind_name_get(render->pages), render->slot_cunt, render->slots[0].esc_len, yt_frame_hash_impl_get(), render->pace, opts->fps_cap);
+
+    pthread_mutex_init(&render->geom_mut, 0x0);
+    pthread_mutex_init(&render->stats_mut, 0x0);
+    pthread_mutex_init(&render->tx_mut, 0x0);
 
-    syslog(LOG_INFO, "render_init; video abs: %u,%u; cells: %ux%u; shm_size: %zu; esc_len: %u/%u", render->video_abs_y, render->video_abs_x, render->video_cell_cols, render->video_cell_rows, render->shm_size, render->esc_len[0], render->esc_len[1]);
+    // pts deadlines are CLOCK_MONOTONIC like everything else here
+    pthread_condattr_t tx_attr;
+    pthread_condattr_init(&tx_attr);
+    pthread_condattr_setclock(&tx_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&render->tx_cond, &tx_attr);
+    pthread_condattr_destroy(&tx_attr);
 
-    pthread_mutex_init(&render->stdout_mut, 0x0);
-    render->running = 1;
-    int pret = pthread_create(&render->render_thread, 0x0, render_loop, render);
-    if (LDG_UNLIKELY(pret != 0))
+    // remote; frames go inline and compressed through the stage thread instead of by shm name
+    int pret = 0;
+    if (render->remote) { err = yt_remote_init(&render->remote_stage, render->output); }
+    else
     {
-        syslog(LOG_ERR, "render_init; pthread_create failed; ret: %d", pret);
+        render->tx_running = 1;
+        pret = pthread_create(&render->tx_thread, 0x0, render_tx_loop, render);
+        render->tx_on = (pret == 0);
+    }
+
+    if (err == LDG_ERR_AOK && pret == 0)
+    {
+        render->running = 1;
+        pret = pthread_create(&render->render_thread, 0x0, render_loop, render);
+    }
+
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK || pret != 0))
+    {
+        syslog(LOG_ERR, "render_init; thread start failed; err: %u; ret: %d", err, pret);
         render->running = 0;
-        pthread_mutex_destroy(&render->stdout_mut);
+        if (render->remote) { yt_remote_shutdown(&render->remote_stage); }
+
+        render_tx_stop(render);
+        pthread_cond_destroy(&render->tx_cond);
+        pthread_mutex_destroy(&render->tx_mut);
+        pthread_mutex_destroy(&render->stats_mut);
+        pthread_mutex_destroy(&render->geom_mut);
         mpv_render_context_free(render->ctx);
         render->ctx = 0x0;
+        close((int)render->wake_fd);
+        render->wake_fd = UINT32_MAX;
         ncplane_destroy(render->video_plane);
         render->video_plane = 0x0;
-        for (b = 0; b < 2; b++) { munmap(render->shm_map[b], render->shm_size); render->shm_map[b] = 0x0; close((int)render->shm_fd[b]); render->shm_fd[b] = UINT32_MAX; }
+        render_ring_close(render);
         return YT_ERR_PLAYER_RENDER_INIT;
     }
 
     return LDG_ERR_AOK;
 }
 
+static const char *const render_stage_names[YT_RENDER_STAGE_CUNT] = { "render", "post", "write", "e2e" };
+
+// every stage on exit; the session's stutter survives in syslog after the view is gone
+static void render_stats_dump(yt_render_t *render)
+{
+    yt_render_stats_t *stats = (yt_render_stats_t *)malloc(sizeof(*stats));
+    if (LDG_UNLIKELY(!stats)) { return; }
+
+    if (yt_render_stats_get(render, stats) == LDG_ERR_AOK)
+    {
+        uint32_t s = 0;
+        for (; s < YT_RENDER_STAGE_CUNT; s++)
+        {
+            const yt_hist_t *hist = &stats->stage[s];
+            syslog(LOG_INFO, "render_stats; stage: %s; cunt: %lu; p50_us: %lu; p99_us: %lu; max_us: %lu", render_stage_names[s], (unsigned long)hist->cunt, (unsigned long)(yt_hist_pct(hist, 500) / 1000), (unsigned long)(yt_hist_pct(hist, 990) / 1000), (unsigned long)(hist->max / 1000));
+        }
+    }
+
+    free(stats);
+}
+
 void yt_render_shutdown(yt_render_t *render)
 {
     if (LDG_UNLIKELY(!render)) { return; }
@@ -286,15 +1541,34 @@ void yt_render_shutdown(yt_render_t *render)
     if (render->running)
     {
         render->running = 0;
+        uint64_t one = 1;
+        ssize_t wake_wr = write((int)render->wake_fd, &one, sizeof(one));
+        if (LDG_UNLIKELY(wake_wr < 0)) { syslog(LOG_ERR, "%s", "render_shutdown; wake write failed"); }
+
         int join_ret = pthread_join(render->render_thread, 0x0);
         if (LDG_UNLIKELY(join_ret != 0)) { syslog(LOG_ERR, "render_shutdown; pthread_join failed; ret: %d", join_ret); }
     }
 
-    pthread_mutex_destroy(&render->stdout_mut);
+    // the remote stage owns half the histograms; read them before it goes
+    render_stats_dump(render);
+    if (render->remote) { yt_remote_shutdown(&render->remote_stage); }
 
-    char del_esc[] = "\x1b_Ga=d,d=I,i=1,q=2;\x1b\\\x1b_Ga=d,d=I,i=2,q=2;\x1b\\";
-    ssize_t wr = write(STDOUT_FILENO, del_esc, sizeof(del_esc) - 1);
-    if (wr < 0) { syslog(LOG_ERR, "%s", "render_shutdown; kitty delete write failed"); }
+    render_tx_stop(render);
+    render_tx_collect(render);
+    render->tx_on = 0;
+    pthread_cond_destroy(&render->tx_cond);
+    pthread_mutex_destroy(&render->tx_mut);
+    pthread_mutex_destroy(&render->stats_mut);
+    pthread_mutex_destroy(&render->geom_mut);
+
+    uint32_t b = 0;
+    for (; render->backend == YT_RENDER_BACKEND_KITTY && b < render->slot_cunt; b++)
+    {
+        char del_esc[YT_RENDER_TAIL_MAX] = LDG_ARR_ZERO_INIT;
+        int del_len = snprintf(del_esc, sizeof(del_esc), "\x1b_Ga=d,d=I,i=%u,q=2;\x1b\\", render->slots[b].kitty_id);
+        struct iovec iov[1] = { { del_esc, (size_t)del_len } };
+        if (yt_output_video_post(render->output, iov, 1) != LDG_ERR_AOK) { syslog(LOG_ERR, "render_shutdown; kitty delete post failed; idx: %u", b); }
+    }
 
     if (render->ctx)
     {
@@ -302,45 +1576,146 @@ void yt_render_shutdown(yt_render_t *render)
         render->ctx = 0x0;
     }
 
+    if (render->wake_fd != UINT32_MAX)
+    {
+        close((int)render->wake_fd);
+        render->wake_fd = UINT32_MAX;
+    }
+
     if (render->video_plane)
     {
         ncplane_destroy(render->video_plane);
         render->video_plane = 0x0;
     }
 
-    uint32_t b = 0;
-    for (; b < 2; b++)
-    {
-        if (render->shm_map[b])
-        {
-            munmap(render->shm_map[b], render->shm_size);
-            render->shm_map[b] = 0x0;
-        }
+    syslog(LOG_INFO, "render_shutdown; dropped: %lu; dup: %lu; delta: %lu; acks: %s", (unsigned long)render->drop_cunt, (unsigned long)render->dup_cunt, (unsigned long)render->delta_cunt, render->remote ? "remote" : (render->ack_off ? "off" : "on"));
 
-        if (render->shm_fd[b] != UINT32_MAX)
-        {
-            close((int)render->shm_fd[b]);
-            render->shm_fd[b] = UINT32_MAX;
-        }
+    yt_sixel_free(&render->sixel);
+    yt_cells_free(&render->cells);
+    render_ring_close(render);
+}
+
+// ui thread; moves the plane now, the render thread refits and grows its buffers on its next wakeup
+uint32_t yt_render_place(yt_render_t *render, struct ncplane *parent, uint32_t y, uint32_t x, uint32_t cell_rows, uint32_t cell_cols)
+{
+    if (LDG_UNLIKELY(!render)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!parent)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!render->running || !render->video_plane)) { return LDG_ERR_NOT_INIT; }
+
+    if (LDG_UNLIKELY(cell_rows == 0 || cell_cols == 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    unsigned pix_y = 0;
+    unsigned pix_x = 0;
+    unsigned cell_px_y = 0;
+    unsigned cell_px_x = 0;
+    unsigned max_bmap_y = 0;
+    unsigned max_bmap_x = 0;
+    ncplane_pixel_geom(parent, &pix_y, &pix_x, &cell_px_y, &cell_px_x, &max_bmap_y, &max_bmap_x);
+
+    if (LDG_UNLIKELY(cell_px_x == 0 || cell_px_y == 0))
+    {
+        syslog(LOG_ERR, "render_place; cell pixel geom zero; cell_px_x: %u; cell_px_y: %u", cell_px_x, cell_px_y);
+        return YT_ERR_PLAYER_RENDER;
     }
 
-    int ul = unlink(YT_RENDER_SHM_PATH_0);
-    if (ul < 0) { syslog(LOG_ERR, "%s", "render_shutdown; shm unlink failed; idx: 0"); }
+    // the layout rebuilds its planes on resize; follow the new parent
+    if (ncplane_parent_const(render->video_plane) != parent) { ncplane_reparent(render->video_plane, parent); }
+
+    if (LDG_UNLIKELY(ncplane_resize_simple(render->video_plane, cell_rows, cell_cols) != 0)) { return YT_ERR_PLAYER_RENDER; }
+
+    ncplane_move_yx(render->video_plane, (int)y, (int)x);
+
+    int abs_y = 0;
+    int abs_x = 0;
+    ncplane_abs_yx(render->video_plane, &abs_y, &abs_x);
+
+    pthread_mutex_lock(&render->geom_mut);
+    render->geom_req.cell_px_x = cell_px_x;
+    render->geom_req.cell_px_y = cell_px_y;
+    render->geom_req.cell_cols = cell_cols;
+    render->geom_req.cell_rows = cell_rows;
+    render->geom_req.abs_y = (uint32_t)abs_y;
+    render->geom_req.abs_x = (uint32_t)abs_x;
+    render->geom_gen++;
+    pthread_mutex_unlock(&render->geom_mut);
+
+    uint64_t one = 1;
+    ssize_t wr = write((int)render->wake_fd, &one, sizeof(one));
+    if (LDG_UNLIKELY(wr < 0)) { return YT_ERR_PLAYER_RENDER; }
 
-    ul = unlink(YT_RENDER_SHM_PATH_1);
-    if (ul < 0) { syslog(LOG_ERR, "%s", "render_shutdown; shm unlink failed; idx: 1"); }
+    return LDG_ERR_AOK;
 }
 
-void yt_render_stdout_lock(yt_render_t *render)
+// full size; top of the parent, centred horizontally
+uint32_t yt_render_reconfigure(yt_render_t *render, struct ncplane *parent, uint32_t cell_rows, uint32_t cell_cols)
 {
-    if (LDG_UNLIKELY(!render)) { return; }
+    if (LDG_UNLIKELY(!parent)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    unsigned parent_rows = 0;
+    unsigned parent_cols = 0;
+    ncplane_dim_yx(parent, &parent_rows, &parent_cols);
+    uint32_t offset_x = (parent_cols > cell_cols) ? (parent_cols - cell_cols) / 2 : 0;
 
-    pthread_mutex_lock(&render->stdout_mut);
+    return yt_render_place(render, parent, 0, offset_x, cell_rows, cell_cols);
 }
 
-void yt_render_stdout_unlock(yt_render_t *render)
+// 0 goes back to the configured cap; otherwise the stricter of the two wins. frames inside the interval are rendered but never sent
+uint32_t yt_render_fps_cap_set(yt_render_t *render, uint32_t fps)
 {
-    if (LDG_UNLIKELY(!render)) { return; }
+    if (LDG_UNLIKELY(!render)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    uint64_t min_ns = (fps != 0) ? LDG_NS_PER_SEC / fps : 0;
+    render->frame_min_ns = (min_ns > render->cap_base_ns) ? min_ns : render->cap_base_ns;
+
+    return LDG_ERR_AOK;
+}
+
+// any thread; the surface the governor and the box settled on, packed so both halves come from one resize
+uint32_t yt_render_surface_get(yt_render_t *render, uint32_t *w, uint32_t *h)
+{
+    if (LDG_UNLIKELY(!render)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!w || !h)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    uint32_t wh = render->surface_wh;
+    *w = wh >> 16;
+    *h = wh & 0xffffu;
+
+    return LDG_ERR_AOK;
+}
+
+uint32_t yt_render_aspect_set(yt_render_t *render, double aspect)
+{
+    if (LDG_UNLIKELY(!render)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    uint32_t aspect_milli = (uint32_t)(aspect * YT_RENDER_ASPECT_DEN + 0.5);
+    if (LDG_UNLIKELY(aspect_milli < YT_RENDER_ASPECT_MIN || aspect_milli > YT_RENDER_ASPECT_MAX)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    if (aspect_milli == render->aspect_req) { return LDG_ERR_AOK; }
+
+    render->aspect_req = aspect_milli;
+
+    uint64_t one = 1;
+    ssize_t wr = write((int)render->wake_fd, &one, sizeof(one));
+    if (LDG_UNLIKELY(wr < 0)) { return YT_ERR_PLAYER_RENDER; }
+
+    return LDG_ERR_AOK;
+}
+
+// ui thread; a consistent copy, the remote stage keeps its own write and e2e histograms
+uint32_t yt_render_stats_get(yt_render_t *render, yt_render_stats_t *stats)
+{
+    if (LDG_UNLIKELY(!render)) { return LDG_ERR_FUNC_ARG_NULL; }
 
-    pthread_mutex_unlock(&render->stdout_mut);
+    if (LDG_UNLIKELY(!stats)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    pthread_mutex_lock(&render->stats_mut);
+    memcpy(stats, &render->stats, sizeof(*stats));
+    pthread_mutex_unlock(&render->stats_mut);
+
+    if (render->remote) { return yt_remote_hist_get(&render->remote_stage, &stats->stage[YT_RENDER_STAGE_WRITE], &stats->stage[YT_RENDER_STAGE_E2E]); }
+
+    return LDG_ERR_AOK;
 }
@@ -0,0 +1,183 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/player/frame.h>
+#include <yeetee/player/sixel.h>
+
+#define YT_SIXEL_HEAD_MAX 64
+#define YT_SIXEL_PALETTE_ENTRY_MAX 24
+#define YT_SIXEL_COLOUR_HEAD_MAX 16
+#define YT_SIXEL_RUN_MIN 4
+#define YT_SIXEL_CHAR_BASE 63
+#define YT_SIXEL_PCT 100
+#define YT_SIXEL_U32_DIGITS 10
+
+static uint32_t sixel_reserve(void **buff, size_t *cap, size_t need)
+{
+    if (need <= *cap) { return LDG_ERR_AOK; }
+
+    void *grown = realloc(*buff, need);
+    if (LDG_UNLIKELY(!grown)) { return LDG_ERR_ALLOC_NULL; }
+
+    *buff = grown;
+    *cap = need;
+
+    return LDG_ERR_AOK;
+}
+
+// snprintf costs more than the whole run loop on a wide band
+static size_t sixel_u32_put(char *out, uint32_t val)
+{
+    char tmp[YT_SIXEL_U32_DIGITS] = LDG_ARR_ZERO_INIT;
+    size_t n = 0;
+    do
+    {
+        tmp[n++] = (char)('0' + val % LDG_BASE_DECIMAL);
+        val /= LDG_BASE_DECIMAL;
+    } while (val != 0);
+
+    size_t i = 0;
+    for (; i < n; i++) { out[i] = tmp[n - 1 - i]; }
+
+    return n;
+}
+
+// one colour's columns across a band, run length coded; trailing blanks are left to the carriage return
+static size_t sixel_colour_put(char *out, const uint8_t *col, uint32_t w)
+{
+    uint32_t end = w;
+    while (end > 0 && col[end - 1] == 0) { end--; }
+
+    size_t o = 0;
+    uint32_t x = 0;
+    while (x < end)
+    {
+        uint8_t bits = col[x];
+        uint32_t run = 1;
+        while (x + run < end && col[x + run] == bits) { run++; }
+
+        char ch = (char)(YT_SIXEL_CHAR_BASE + bits);
+        if (run >= YT_SIXEL_RUN_MIN)
+        {
+            out[o++] = '!';
+            o += sixel_u32_put(out + o, run);
+            out[o++] = ch;
+        }
+        else
+        {
+            uint32_t r = 0;
+            for (; r < run; r++) { out[o++] = ch; }
+        }
+
+        x += run;
+    }
+
+    return o;
+}
+
+// rows y0 .. y0 + rows of an rgb0 frame as one sixel image; unset pixels stay transparent (P2=1)
+uint32_t yt_sixel_encode(yt_sixel_t *sixel, const uint8_t *pixels, uint32_t w, size_t stride, uint32_t y0, uint32_t rows)
+{
+    if (LDG_UNLIKELY(!sixel)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!pixels)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(w == 0 || rows == 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    sixel->out_len = 0;
+
+    uint32_t err = sixel_reserve((void **)&sixel->idx, &sixel->idx_cap, (size_t)w * rows);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    err = sixel_reserve((void **)&sixel->bits, &sixel->bits_cap, (size_t)YT_FRAME_PALETTE_SIZE * w);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    err = sixel_reserve((void **)&sixel->out, &sixel->out_cap, YT_SIXEL_HEAD_MAX + (size_t)YT_FRAME_PALETTE_SIZE * YT_SIXEL_PALETTE_ENTRY_MAX);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    // dither rows keyed on the absolute row, so a band re-sent later quantizes the same way
+    yt_frame_quant(pixels + (size_t)y0 * stride, w, rows, stride, y0, sixel->idx);
+
+    char *out = sixel->out;
+    size_t o = (size_t)snprintf(out, YT_SIXEL_HEAD_MAX, "\x1bP0;1;0q\"1;1;%u;%u", w, rows);
+
+    uint32_t c = 0;
+    for (; c < YT_FRAME_PALETTE_SIZE; c++)
+    {
+        uint32_t r = 0;
+        uint32_t g = 0;
+        uint32_t b = 0;
+        yt_frame_palette_get(c, &r, &g, &b);
+        o += (size_t)snprintf(out + o, YT_SIXEL_PALETTE_ENTRY_MAX, "#%u;2;%u;%u;%u", c, (r * YT_SIXEL_PCT + 127) / 255, (g * YT_SIXEL_PCT + 127) / 255, (b * YT_SIXEL_PCT + 127) / 255);
+    }
+
+    uint32_t by = 0;
+    for (; by < rows; by += YT_SIXEL_BAND_PX)
+    {
+        uint8_t used[YT_FRAME_PALETTE_SIZE] = LDG_ARR_ZERO_INIT;
+        uint8_t list[YT_FRAME_PALETTE_SIZE] = LDG_ARR_ZERO_INIT;
+        uint32_t used_cunt = 0;
+        uint32_t band_h = (rows - by < YT_SIXEL_BAND_PX) ? rows - by : YT_SIXEL_BAND_PX;
+
+        // one pass over the band scatters each pixel's bit into its colour's column row
+        uint32_t r = 0;
+        for (; r < band_h; r++)
+        {
+            const uint8_t *row = sixel->idx + (size_t)(by + r) * w;
+            uint8_t bit = (uint8_t)(1u << r);
+
+            uint32_t x = 0;
+            for (; x < w; x++)
+            {
+                uint8_t ci = row[x];
+                if (!used[ci])
+                {
+                    used[ci] = 1;
+                    list[used_cunt++] = ci;
+                    memset(sixel->bits + (size_t)ci * w, 0, w);
+                }
+
+                sixel->bits[(size_t)ci * w + x] |= bit;
+            }
+        }
+
+        uint32_t k = 0;
+        for (; k < used_cunt; k++)
+        {
+            err = sixel_reserve((void **)&sixel->out, &sixel->out_cap, o + w + YT_SIXEL_COLOUR_HEAD_MAX);
+            if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+            out = sixel->out;
+            out[o++] = '#';
+            o += sixel_u32_put(out + o, list[k]);
+            o += sixel_colour_put(out + o, sixel->bits + (size_t)list[k] * w, w);
+            out[o++] = '$';
+        }
+
+        // graphics newline on every band but the last
+        if (by + YT_SIXEL_BAND_PX < rows) { out[o - 1] = '-'; }
+    }
+
+    err = sixel_reserve((void **)&sixel->out, &sixel->out_cap, o + 2);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { return err; }
+
+    out = sixel->out;
+    out[o++] = '\x1b';
+    out[o++] = '\\';
+    sixel->out_len = o;
+
+    return LDG_ERR_AOK;
+}
+
+void yt_sixel_free(yt_sixel_t *sixel)
+{
+    if (LDG_UNLIKELY(!sixel)) { return; }
+
+    free(sixel->idx);
+    free(sixel->bits);
+    free(sixel->out);
+    memset(sixel, 0, sizeof(*sixel));
+}
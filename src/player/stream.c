@@ -0,0 +1,530 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <dangling/core/macros.h>
+#include <dangling/core/err.h>
+#include <yeetee/yeetee.h>
+#include <yeetee/core/err.h>
+#include <yeetee/player/stream.h>
+
+#define YT_STREAM_FPS_DEFAULT 30
+#define YT_STREAM_ASPECT_NUM 16
+#define YT_STREAM_ASPECT_DEN 9
+#define YT_STREAM_CACHE_MAGIC 0x43535459
+#define YT_STREAM_CACHE_VERSION 1
+
+typedef struct yt_stream_cache_hdr
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t expire_epoch;
+    uint32_t set_size;
+    uint8_t pudding[4];
+} yt_stream_cache_hdr_t;
+
+// software decode cost per pixel in eighths of avc; vp9 and av1 are what mpv/yt-dlp pick on their own
+static const uint32_t stream_codec_cost[YT_STREAM_CODEC_CUNT] = {
+    [YT_STREAM_CODEC_UNKNOWN] = 12,
+    [YT_STREAM_CODEC_AVC] = 8,
+    [YT_STREAM_CODEC_VP9] = 12,
+    [YT_STREAM_CODEC_AV1] = 16,
+};
+
+// the codecs="..." part of the mime; avc1.640028, vp9 / vp09.00.40.08, av01.0.08M.08
+yt_stream_codec_t yt_stream_codec_get(const yt_stream_t *stream)
+{
+    if (LDG_UNLIKELY(!stream)) { return YT_STREAM_CODEC_UNKNOWN; }
+
+    const char *codecs = strstr(stream->mime, "codecs=");
+    if (!codecs) { return YT_STREAM_CODEC_UNKNOWN; }
+
+    codecs += 7;
+    if (*codecs == '"') { codecs++; }
+
+    if (strncmp(codecs, "avc1", 4) == 0 || strncmp(codecs, "avc3", 4) == 0 || strncmp(codecs, "h264", 4) == 0) { return YT_STREAM_CODEC_AVC; }
+
+    if (strncmp(codecs, "vp9", 3) == 0 || strncmp(codecs, "vp09", 4) == 0) { return YT_STREAM_CODEC_VP9; }
+
+    if (strncmp(codecs, "av01", 4) == 0) { return YT_STREAM_CODEC_AV1; }
+
+    return YT_STREAM_CODEC_UNKNOWN;
+}
+
+static uint32_t stream_width_get(const yt_stream_t *stream)
+{
+    if (stream->width != 0) { return stream->width; }
+
+    return stream->height * YT_STREAM_ASPECT_NUM / YT_STREAM_ASPECT_DEN;
+}
+
+// pixels a second times the codec weight; only ever compared against other streams
+uint64_t yt_stream_cost_get(const yt_stream_t *stream)
+{
+    if (LDG_UNLIKELY(!stream)) { return 0; }
+
+    uint64_t fps = (stream->fps != 0) ? stream->fps : YT_STREAM_FPS_DEFAULT;
+
+    return (uint64_t)stream_width_get(stream) * stream->height * fps * stream_codec_cost[yt_stream_codec_get(stream)];
+}
+
+// a sixteenth short still counts; the surface is fitted to the video, so rounding lands on either side
+static uint8_t stream_covers(const yt_stream_t *stream, uint32_t target_w, uint32_t target_h)
+{
+    return ((uint64_t)stream_width_get(stream) * 16 >= (uint64_t)target_w * 15) && ((uint64_t)stream->height * 16 >= (uint64_t)target_h * 15);
+}
+
+// among streams that cover the surface the cheapest to decode wins; when none does, the largest
+static uint8_t stream_video_better(const yt_stream_t *cand, const yt_stream_t *best, uint32_t target_w, uint32_t target_h)
+{
+    if (!best) { return 1; }
+
+    uint8_t cand_covers = stream_covers(cand, target_w, target_h);
+    uint8_t best_covers = stream_covers(best, target_w, target_h);
+    if (cand_covers != best_covers) { return cand_covers; }
+
+    if (!cand_covers)
+    {
+        uint64_t cand_px = (uint64_t)stream_width_get(cand) * cand->height;
+        uint64_t best_px = (uint64_t)stream_width_get(best) * best->height;
+        if (cand_px != best_px) { return cand_px > best_px; }
+    }
+
+    uint64_t cand_cost = yt_stream_cost_get(cand);
+    uint64_t best_cost = yt_stream_cost_get(best);
+    if (cand_cost != best_cost) { return cand_cost < best_cost; }
+
+    return cand->bitrate < best->bitrate;
+}
+
+// the smallest, cheapest video that still covers target_w x target_h, plus the best audio
+// separate video and audio beat a muxed stream; youtube only muxes up to 360p
+uint32_t yt_stream_pick(const yt_stream_set_t *set, uint32_t target_w, uint32_t target_h, yt_stream_pick_t *pick)
+{
+    if (LDG_UNLIKELY(!set)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!pick)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    pick->video_idx = UINT32_MAX;
+    pick->audio_idx = UINT32_MAX;
+
+    const yt_stream_t *video = 0x0;
+    const yt_stream_t *muxed = 0x0;
+    const yt_stream_t *audio = 0x0;
+    uint32_t muxed_idx = UINT32_MAX;
+    uint32_t i = 0;
+    for (; i < set->stream_cunt; i++)
+    {
+        const yt_stream_t *s = &set->streams[i];
+        if (s->url[0] == '\0') { continue; }
+
+        if (s->is_audio)
+        {
+            if (!audio || s->bitrate > audio->bitrate)
+            {
+                audio = s;
+                pick->audio_idx = i;
+            }
+
+            continue;
+        }
+
+        if (s->muxed)
+        {
+            if (stream_video_better(s, muxed, target_w, target_h))
+            {
+                muxed = s;
+                muxed_idx = i;
+            }
+
+            continue;
+        }
+
+        if (stream_video_better(s, video, target_w, target_h))
+        {
+            video = s;
+            pick->video_idx = i;
+        }
+    }
+
+    if (video && (audio || !muxed)) { return LDG_ERR_AOK; }
+
+    if (muxed)
+    {
+        pick->video_idx = muxed_idx;
+        pick->audio_idx = UINT32_MAX;
+        return LDG_ERR_AOK;
+    }
+
+    pick->audio_idx = UINT32_MAX;
+
+    return YT_ERR_PLAYER_NO_STREAM;
+}
+
+// audio only: the highest bitrate audio stream and no video; a set without one falls back to the cheapest muxed stream
+uint32_t yt_stream_pick_audio(const yt_stream_set_t *set, yt_stream_pick_t *pick)
+{
+    if (LDG_UNLIKELY(!set)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!pick)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    pick->video_idx = UINT32_MAX;
+    pick->audio_idx = UINT32_MAX;
+
+    const yt_stream_t *audio = 0x0;
+    const yt_stream_t *muxed = 0x0;
+    uint32_t muxed_idx = UINT32_MAX;
+    uint32_t i = 0;
+    for (; i < set->stream_cunt; i++)
+    {
+        const yt_stream_t *s = &set->streams[i];
+        if (s->url[0] == '\0') { continue; }
+
+        if (s->is_audio)
+        {
+            if (!audio || s->bitrate > audio->bitrate)
+            {
+                audio = s;
+                pick->audio_idx = i;
+            }
+
+            continue;
+        }
+
+        if (s->muxed && (!muxed || yt_stream_cost_get(s) < yt_stream_cost_get(muxed)))
+        {
+            muxed = s;
+            muxed_idx = i;
+        }
+    }
+
+    if (audio) { return LDG_ERR_AOK; }
+
+    if (muxed)
+    {
+        pick->video_idx = muxed_idx;
+        return LDG_ERR_AOK;
+    }
+
+    return YT_ERR_PLAYER_NO_STREAM;
+}
+
+// switching reloads the file, so only for a stream that no longer covers the surface or one at half the cost
+uint8_t yt_stream_switch_worth(const yt_stream_set_t *set, const yt_stream_pick_t *cur, const yt_stream_pick_t *next, uint32_t target_w, uint32_t target_h)
+{
+    if (LDG_UNLIKELY(!set || !cur || !next)) { return 0; }
+
+    if (next->video_idx == cur->video_idx) { return 0; }
+
+    if (cur->video_idx >= set->stream_cunt || next->video_idx >= set->stream_cunt) { return 0; }
+
+    const yt_stream_t *cur_s = &set->streams[cur->video_idx];
+    const yt_stream_t *next_s = &set->streams[next->video_idx];
+
+    if (!stream_covers(cur_s, target_w, target_h)) { return stream_covers(next_s, target_w, target_h) || next_s->height > cur_s->height; }
+
+    return yt_stream_cost_get(next_s) * 2 <= yt_stream_cost_get(cur_s);
+}
+
+// %len% quoting takes the url verbatim, so the ; and , inside signed urls need no escaping
+static uint32_t stream_edl_part(char *out, size_t out_len, size_t *pos, const char *prefix, const char *url)
+{
+    int n = snprintf(out + *pos, out_len - *pos, "%s!no_clip;!no_chapters;%%%zu%%%s", prefix, strlen(url), url);
+    if (LDG_UNLIKELY(n < 0 || (size_t)n >= out_len - *pos)) { return LDG_ERR_STR_TRUNC; }
+
+    *pos += (size_t)n;
+
+    return LDG_ERR_AOK;
+}
+
+// one edl:// url mpv opens as a single file; !new_stream muxes the audio in next to the video, the way ytdl_hook does it
+uint32_t yt_stream_edl_build(const char *video_url, const char *audio_url, char *out, size_t out_len)
+{
+    if (LDG_UNLIKELY(!video_url)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!out)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(out_len == 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    size_t pos = 0;
+    uint32_t ret = stream_edl_part(out, out_len, &pos, "edl://", video_url);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return ret; }
+
+    if (audio_url && audio_url[0] != '\0')
+    {
+        ret = stream_edl_part(out, out_len, &pos, ";!new_stream;", audio_url);
+        if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return ret; }
+    }
+
+    return LDG_ERR_AOK;
+}
+
+uint32_t yt_stream_url_build(const yt_stream_set_t *set, const yt_stream_pick_t *pick, char *out, size_t out_len)
+{
+    if (LDG_UNLIKELY(!set)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!pick)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    const char *audio_url = (pick->audio_idx < set->stream_cunt) ? set->streams[pick->audio_idx].url : 0x0;
+
+    // an audio only pick is a one part edl
+    if (pick->video_idx >= set->stream_cunt)
+    {
+        if (LDG_UNLIKELY(!audio_url)) { return YT_ERR_PLAYER_NO_STREAM; }
+
+        return yt_stream_edl_build(audio_url, 0x0, out, out_len);
+    }
+
+    return yt_stream_edl_build(set->streams[pick->video_idx].url, audio_url, out, out_len);
+}
+
+// signed googlevideo urls carry expire=<epoch> in the query; a set is good until its first url runs out, and a url
+// without one makes the whole set uncacheable
+uint64_t yt_stream_expire_get(const yt_stream_set_t *set)
+{
+    if (LDG_UNLIKELY(!set)) { return 0; }
+
+    uint64_t expire = 0;
+    uint32_t i = 0;
+    for (; i < set->stream_cunt; i++)
+    {
+        const char *url = set->streams[i].url;
+        if (url[0] == '\0') { continue; }
+
+        const char *p = strstr(url, "expire=");
+        while (p && p != url && p[-1] != '?' && p[-1] != '&') { p = strstr(p + 7, "expire="); }
+
+        if (!p) { return 0; }
+
+        p += 7;
+        uint64_t val = 0;
+        for (; *p >= '0' && *p <= '9'; p++) { val = val * LDG_BASE_DECIMAL + (uint64_t)(*p - '0'); }
+
+        if (val == 0) { return 0; }
+
+        if (expire == 0 || val < expire) { expire = val; }
+    }
+
+    return expire;
+}
+
+uint32_t yt_stream_cache_init(yt_stream_cache_t *cache, uint32_t capacity)
+{
+    if (LDG_UNLIKELY(!cache)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(capacity == 0)) { return LDG_ERR_FUNC_ARG_INVALID; }
+
+    cache->entries = (yt_stream_cache_entry_t *)calloc(capacity, sizeof(yt_stream_cache_entry_t));
+    if (LDG_UNLIKELY(!cache->entries)) { return LDG_ERR_ALLOC_NULL; }
+
+    cache->capacity = capacity;
+    cache->cunt = 0;
+    cache->tick = 0;
+
+    return LDG_ERR_AOK;
+}
+
+void yt_stream_cache_shutdown(yt_stream_cache_t *cache)
+{
+    if (LDG_UNLIKELY(!cache)) { return; }
+
+    free(cache->entries);
+    cache->entries = 0x0;
+    cache->capacity = 0;
+    cache->cunt = 0;
+}
+
+// the set for video_id while it still has the margin left, 0x0 otherwise; expired entries are dropped on the way
+const yt_stream_set_t* yt_stream_cache_get(yt_stream_cache_t *cache, const char *video_id, uint64_t now_epoch)
+{
+    if (LDG_UNLIKELY(!cache || !cache->entries)) { return 0x0; }
+
+    if (LDG_UNLIKELY(!video_id)) { return 0x0; }
+
+    uint32_t i = 0;
+    for (; i < cache->cunt; i++)
+    {
+        yt_stream_cache_entry_t *entry = &cache->entries[i];
+        if (entry->video_id[0] == '\0' || strncmp(entry->video_id, video_id, YT_VIDEO_ID_MAX) != 0) { continue; }
+
+        if (now_epoch + YT_STREAM_EXPIRE_MARGIN_SECS >= entry->expire_epoch)
+        {
+            entry->video_id[0] = '\0';
+            return 0x0;
+        }
+
+        entry->last_used = ++cache->tick;
+        return &entry->set;
+    }
+
+    return 0x0;
+}
+
+uint32_t yt_stream_cache_put(yt_stream_cache_t *cache, const char *video_id, const yt_stream_set_t *set, uint64_t now_epoch)
+{
+    if (LDG_UNLIKELY(!cache || !cache->entries)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!video_id)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!set)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    uint64_t expire = yt_stream_expire_get(set);
+    if (now_epoch + YT_STREAM_EXPIRE_MARGIN_SECS >= expire) { return YT_ERR_PLAYER_STREAM_EXPIRED; }
+
+    // same video, then a free or dropped entry, then the least recently used
+    yt_stream_cache_entry_t *slot = 0x0;
+    yt_stream_cache_entry_t *lru = 0x0;
+    uint32_t i = 0;
+    for (; i < cache->cunt; i++)
+    {
+        yt_stream_cache_entry_t *entry = &cache->entries[i];
+        if (strncmp(entry->video_id, video_id, YT_VIDEO_ID_MAX) == 0)
+        {
+            slot = entry;
+            break;
+        }
+
+        if (entry->video_id[0] == '\0') { lru = entry; }
+        else if (!lru || (lru->video_id[0] != '\0' && entry->last_used < lru->last_used)) { lru = entry; }
+    }
+
+    if (!slot && cache->cunt < cache->capacity)
+    {
+        slot = &cache->entries[cache->cunt];
+        cache->cunt++;
+    }
+
+    if (!slot) { slot = lru; }
+
+    memcpy(&slot->set, set, sizeof(slot->set));
+    snprintf(slot->video_id, sizeof(slot->video_id), "%s", video_id);
+    slot->expire_epoch = expire;
+    slot->last_used = ++cache->tick;
+
+    return LDG_ERR_AOK;
+}
+
+static uint8_t stream_cache_hdr_read(int fd, yt_stream_cache_hdr_t *hdr)
+{
+    ssize_t got = read(fd, hdr, sizeof(*hdr));
+
+    return (got == (ssize_t)sizeof(*hdr)) && hdr->magic == YT_STREAM_CACHE_MAGIC && hdr->version == YT_STREAM_CACHE_VERSION && hdr->set_size == sizeof(yt_stream_set_t);
+}
+
+// <cache_dir>/stream_<id>.bin, a header and the set as it sits in memory; a stale or foreign file is removed
+uint32_t yt_stream_cache_file_load(const char *cache_dir, const char *video_id, yt_stream_set_t *set, uint64_t now_epoch)
+{
+    if (LDG_UNLIKELY(!cache_dir)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!video_id)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!set)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    char path[YT_STREAM_CACHE_PATH_MAX] = LDG_ARR_ZERO_INIT;
+    snprintf(path, sizeof(path), "%s/stream_%s.bin", cache_dir, video_id);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { return LDG_ERR_IO_OPEN; }
+
+    yt_stream_cache_hdr_t hdr = LDG_STRUCT_ZERO_INIT;
+    uint8_t valid = stream_cache_hdr_read(fd, &hdr);
+    ssize_t got = 0;
+    if (valid) { got = read(fd, set, sizeof(*set)); }
+
+    close(fd);
+
+    if (!valid || got != (ssize_t)sizeof(*set) || set->stream_cunt > YT_STREAM_MAX)
+    {
+        unlink(path);
+        return LDG_ERR_IO_READ;
+    }
+
+    if (now_epoch + YT_STREAM_EXPIRE_MARGIN_SECS >= hdr.expire_epoch)
+    {
+        unlink(path);
+        return YT_ERR_PLAYER_STREAM_EXPIRED;
+    }
+
+    return LDG_ERR_AOK;
+}
+
+// written next to the final name and renamed over it, so a reader never sees half a set
+uint32_t yt_stream_cache_file_save(const char *cache_dir, const char *video_id, const yt_stream_set_t *set)
+{
+    if (LDG_UNLIKELY(!cache_dir)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!video_id)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    if (LDG_UNLIKELY(!set)) { return LDG_ERR_FUNC_ARG_NULL; }
+
+    yt_stream_cache_hdr_t hdr = LDG_STRUCT_ZERO_INIT;
+    hdr.magic = YT_STREAM_CACHE_MAGIC;
+    hdr.version = YT_STREAM_CACHE_VERSION;
+    hdr.expire_epoch = yt_stream_expire_get(set);
+    hdr.set_size = sizeof(*set);
+    if (hdr.expire_epoch == 0) { return YT_ERR_PLAYER_STREAM_EXPIRED; }
+
+    char path[YT_STREAM_CACHE_PATH_MAX] = LDG_ARR_ZERO_INIT;
+    char tmp_path[YT_STREAM_CACHE_PATH_MAX] = LDG_ARR_ZERO_INIT;
+    snprintf(path, sizeof(path), "%s/stream_%s.bin", cache_dir, video_id);
+    snprintf(tmp_path, sizeof(tmp_path), "%s/stream_%s.tmp", cache_dir, video_id);
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (LDG_UNLIKELY(fd < 0)) { return LDG_ERR_IO_OPEN; }
+
+    ssize_t hdr_written = write(fd, &hdr, sizeof(hdr));
+    ssize_t set_written = write(fd, set, sizeof(*set));
+    int cr = close(fd);
+    if (LDG_UNLIKELY(hdr_written != (ssize_t)sizeof(hdr) || set_written != (ssize_t)sizeof(*set) || cr != 0))
+    {
+        unlink(tmp_path);
+        return LDG_ERR_IO_WRITE;
+    }
+
+    if (LDG_UNLIKELY(rename(tmp_path, path) != 0))
+    {
+        unlink(tmp_path);
+        return LDG_ERR_IO_WRITE;
+    }
+
+    return LDG_ERR_AOK;
+}
+
+// most sets are never read back; anything expired or unreadable goes, returns how many files were removed
+uint32_t yt_stream_cache_file_sweep(const char *cache_dir, uint64_t now_epoch)
+{
+    if (LDG_UNLIKELY(!cache_dir)) { return 0; }
+
+    DIR *dir = opendir(cache_dir);
+    if (!dir) { return 0; }
+
+    uint32_t removed = 0;
+    struct dirent *ent = 0x0;
+    while ((ent = readdir(dir)) != 0x0)
+    {
+        size_t name_len = strlen(ent->d_name);
+        if (strncmp(ent->d_name, "stream_", 7) != 0 || name_len < 11 || strcmp(ent->d_name + name_len - 4, ".bin") != 0) { continue; }
+
+        char path[YT_STREAM_CACHE_PATH_MAX] = LDG_ARR_ZERO_INIT;
+        snprintf(path, sizeof(path), "%s/%s", cache_dir, ent->d_name);
+
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) { continue; }
+
+        yt_stream_cache_hdr_t hdr = LDG_STRUCT_ZERO_INIT;
+        uint8_t valid = stream_cache_hdr_read(fd, &hdr);
+        close(fd);
+
+        if (valid && now_epoch + YT_STREAM_EXPIRE_MARGIN_SECS < hdr.expire_epoch) { continue; }
+
+        if (unlink(path) == 0) { removed++; }
+    }
+
+    closedir(dir);
+
+    return removed;
+}
@@ -69,6 +69,18 @@ yt_action_t yt_input_dispatch(const struct ncinput *ni)
         case 'r':
             return YT_ACTION_REFRESH;
 
+        case 'i':
+            return YT_ACTION_STATS;
+
+        case 'v':
+            return YT_ACTION_PLAYER;
+
+        case 'x':
+            return YT_ACTION_STOP;
+
+        case 'o':
+            return YT_ACTION_AUDIO;
+
         default:
             return YT_ACTION_NONE;
     }
@@ -116,6 +116,10 @@ uint32_t yt_queue_shuffle(yt_queue_t *q)
         tmp = q->items[i];
         q->items[i] = q->items[j];
         q->items[j] = tmp;
+
+        // current follows the video, not the slot; shuffling never changes what is playing
+        if (q->current_idx == i) { q->current_idx = j; }
+        else if (q->current_idx == j) { q->current_idx = i; }
     }
 
     return LDG_ERR_AOK;
@@ -1,9 +1,13 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <signal.h>
+#include <poll.h>
 #include <time.h>
 #include <syslog.h>
 #include <notcurses/notcurses.h>
@@ -20,6 +24,7 @@
 #include <yeetee/api/ytdlp.h>
 #include <yeetee/player/player.h>
 #include <yeetee/player/render.h>
+#include <yeetee/player/stream.h>
 #include <yeetee/tui/layout.h>
 #include <yeetee/tui/input.h>
 #include <yeetee/tui/feed.h>
@@ -30,6 +35,11 @@
 #define YT_TUI_SEEK_SECS 10.0
 #define YT_TUI_VOL_STEP 5
 #define YT_TUI_VIDEO_INFO_ROWS 3
+#define YT_TUI_RESIZE_DEBOUNCE_NS 100000000
+#define YT_TUI_PIP_DIV 3
+#define YT_TUI_PIP_FPS 10
+#define YT_TUI_RESELECT_SETTLE_NS 1500000000
+#define YT_TUI_SPEC_DWELL_NS 400000000
 
 // term rst
 static void tui_term_reset(void)
@@ -95,6 +105,34 @@ typedef struct tui_thumb_task_ctx
     ldg_spsc_queue_t *result_q;
 } tui_thumb_task_ctx_t;
 
+// stream task context; gen ties the result to the playlist window it was asked for
+// cache_dir is empty unless resolved sets are kept on disk
+typedef struct tui_stream_task_ctx
+{
+    char access_token[YT_TOKEN_ACCESS_MAX];
+    char video_id[YT_VIDEO_ID_MAX];
+    char cache_dir[YT_CONF_CACHE_DIR_MAX];
+    uint32_t idx;
+    uint32_t gen;
+    ldg_spsc_queue_t *result_q;
+} tui_stream_task_ctx_t;
+
+// disk stream cache sweep context
+typedef struct tui_sweep_task_ctx
+{
+    char cache_dir[YT_CONF_CACHE_DIR_MAX];
+} tui_sweep_task_ctx_t;
+
+// stream result
+typedef struct tui_stream_result
+{
+    yt_stream_set_t streams;
+    char video_id[YT_VIDEO_ID_MAX];
+    uint32_t idx;
+    uint32_t gen;
+    uint32_t err;
+} tui_stream_result_t;
+
 // thumb result
 typedef struct tui_thumb_result
 {
@@ -173,6 +211,72 @@ static void search_task(void *arg)
     free(ctx);
 }
 
+// stream worker; a set still fresh on disk first, then innertube, then yt-dlp when innertube has nothing mpv can open
+// without deciphering
+static void stream_resolve_task(void *arg)
+{
+    tui_stream_task_ctx_t *ctx = (tui_stream_task_ctx_t *)arg;
+    yt_innertube_ctx_t api = LDG_STRUCT_ZERO_INIT;
+    yt_stream_pick_t pick = LDG_STRUCT_ZERO_INIT;
+    uint32_t ret = 0;
+
+    tui_stream_result_t *result = (tui_stream_result_t *)malloc(sizeof(tui_stream_result_t));
+    if (LDG_UNLIKELY(!result))
+    {
+        free(ctx);
+        return;
+    }
+
+    memset(result, 0, sizeof(*result));
+    snprintf(result->video_id, sizeof(result->video_id), "%s", ctx->video_id);
+    result->idx = ctx->idx;
+    result->gen = ctx->gen;
+
+    if (ctx->cache_dir[0] != '\0' && yt_stream_cache_file_load(ctx->cache_dir, ctx->video_id, &result->streams, (uint64_t)time(0x0)) == LDG_ERR_AOK)
+    {
+        result->err = LDG_ERR_AOK;
+        ldg_spsc_push(ctx->result_q, result);
+
+        free(result);
+        free(ctx);
+        return;
+    }
+
+    ret = yt_innertube_ctx_init(&api, ctx->access_token);
+    if (ret == LDG_ERR_AOK)
+    {
+        ret = yt_innertube_player(&api, ctx->video_id, &result->streams);
+        yt_innertube_ctx_shutdown(&api);
+    }
+
+    if (ret == LDG_ERR_AOK) { ret = yt_stream_pick(&result->streams, YT_RENDER_MAX_W, YT_RENDER_MAX_H, &pick); }
+
+    if (ret != LDG_ERR_AOK)
+    {
+        syslog(LOG_INFO, "stream_resolve_task; innertube unusable, trying yt-dlp; ret: %u", ret);
+        ret = yt_ytdlp_stream_url_get(ctx->video_id, &result->streams);
+    }
+
+    if (ret == LDG_ERR_AOK && ctx->cache_dir[0] != '\0') { yt_stream_cache_file_save(ctx->cache_dir, ctx->video_id, &result->streams); }
+
+    result->err = ret;
+    ldg_spsc_push(ctx->result_q, result);
+
+    free(result);
+    free(ctx);
+}
+
+// sets resolved once and never played again would stay on disk for good; cleared out once a start
+static void stream_sweep_task(void *arg)
+{
+    tui_sweep_task_ctx_t *ctx = (tui_sweep_task_ctx_t *)arg;
+
+    uint32_t removed = yt_stream_cache_file_sweep(ctx->cache_dir, (uint64_t)time(0x0));
+    if (removed > 0) { syslog(LOG_INFO, "stream_sweep_task; removed: %u", removed); }
+
+    free(ctx);
+}
+
 // thumb worker
 static void thumb_fetch_task(void *arg)
 {
@@ -299,15 +403,212 @@ static void tui_auth_start(yt_tui_t *tui)
     }
 }
 
+// the diff is rasterized here but written by the output thread, in the same writev as the next video frame
+static void tui_flush(yt_tui_t *tui)
+{
+    char *buff = 0x0;
+    size_t len = 0;
+    if (LDG_UNLIKELY(ncpile_render_to_buffer(notcurses_stdplane(tui->nc), &buff, &len) != 0))
+    {
+        syslog(LOG_ERR, "%s", "tui_flush; ncpile_render_to_buffer failed");
+        return;
+    }
+
+    uint32_t err = yt_output_ui_post(&tui->output, buff, len);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK)) { syslog(LOG_ERR, "tui_flush; ui post failed; err: %u", err); }
+
+    free(buff);
+}
+
 // player
+static void tui_render_opts_build(yt_tui_t *tui, yt_render_opts_t *opts)
+{
+    memset(opts, 0, sizeof(*opts));
+    opts->output = &tui->output;
+
+    // whatever notcurses found at startup; tmux without passthrough and plain xterm land on cells
+    ncpixelimpl_e pix = notcurses_check_pixel_support(tui->nc);
+    switch (tui->conf->render_backend)
+    {
+        case YT_CONF_RENDER_BACKEND_KITTY:
+            opts->backend = YT_RENDER_BACKEND_KITTY;
+            break;
+
+        case YT_CONF_RENDER_BACKEND_SIXEL:
+            opts->backend = YT_RENDER_BACKEND_SIXEL;
+            break;
+
+        case YT_CONF_RENDER_BACKEND_CELLS:
+            opts->backend = YT_RENDER_BACKEND_CELLS;
+            break;
+
+        default:
+            if (pix >= NCPIXEL_KITTY_STATIC) { opts->backend = YT_RENDER_BACKEND_KITTY; }
+            else if (pix == NCPIXEL_SIXEL) { opts->backend = YT_RENDER_BACKEND_SIXEL; }
+            else { opts->backend = YT_RENDER_BACKEND_CELLS; }
+
+            break;
+    }
+
+    // every kitty-protocol terminal takes f=24; rgba stays as an escape hatch
+    opts->fmt = (tui->conf->render_fmt == YT_CONF_RENDER_FMT_RGBA) ? YT_FRAME_FMT_RGBA32 : YT_FRAME_FMT_RGB24;
+
+    // deeper rings ride out terminal hiccups at the cost of one more shm frame each
+    opts->ring_depth = tui->conf->render_ring_depth;
+    if (opts->ring_depth < YT_RENDER_RING_MIN) { opts->ring_depth = YT_RENDER_RING_MIN; }
+
+    if (opts->ring_depth > YT_RENDER_RING_MAX) { opts->ring_depth = YT_RENDER_RING_MAX; }
+
+    opts->governor = (tui->conf->render_governor != 0);
+
+    // frames go out on their pts and mpv hears about every swap; off sends each frame the moment it is drawn
+    opts->pace = (tui->conf->render_pace != 0);
+    opts->fps_cap = tui->conf->render_fps_cap;
+
+    // shm names mean nothing to a terminal on the far side of ssh; frames go inline there
+    if (tui->conf->render_remote == YT_CONF_RENDER_REMOTE_AUTO) { opts->remote = yt_remote_detect(); }
+    else { opts->remote = (tui->conf->render_remote == YT_CONF_RENDER_REMOTE_ON); }
+
+    // KiB/s in the conf
+    uint64_t budget = (uint64_t)tui->conf->render_remote_budget * 1024;
+    opts->remote_budget = (budget > UINT32_MAX) ? UINT32_MAX : (uint32_t)budget;
+}
+
+static void tui_video_box_get(yt_tui_t *tui, uint32_t *video_rows, uint32_t *video_cols)
+{
+    unsigned content_rows = 0;
+    unsigned content_cols = 0;
+    ncplane_dim_yx(tui->layout.content, &content_rows, &content_cols);
+
+    *video_rows = (content_rows > YT_TUI_VIDEO_INFO_ROWS) ? content_rows - YT_TUI_VIDEO_INFO_ROWS : content_rows;
+    *video_cols = content_cols * 95 / 100;
+}
+
+// bottom right of the content plane, a third of each side; the renderer fits the aspect inside it
+static void tui_pip_box_get(yt_tui_t *tui, uint32_t *y, uint32_t *x, uint32_t *rows, uint32_t *cols)
+{
+    unsigned content_rows = 0;
+    unsigned content_cols = 0;
+    ncplane_dim_yx(tui->layout.content, &content_rows, &content_cols);
+
+    *rows = (content_rows >= YT_TUI_PIP_DIV) ? content_rows / YT_TUI_PIP_DIV : 1;
+    *cols = (content_cols >= YT_TUI_PIP_DIV) ? content_cols / YT_TUI_PIP_DIV : 1;
+    *y = (content_rows > *rows) ? content_rows - *rows : 0;
+    *x = (content_cols > *cols + 1) ? content_cols - *cols - 1 : 0;
+}
+
+static uint32_t tui_pip_place(yt_tui_t *tui)
+{
+    uint32_t y = 0;
+    uint32_t x = 0;
+    uint32_t rows = 0;
+    uint32_t cols = 0;
+    tui_pip_box_get(tui, &y, &x, &rows, &cols);
+
+    return yt_render_place(&tui->render, tui->layout.content, y, x, rows, cols);
+}
+
+// mpv's playlist goes away; a resolve still in flight lands on a stale gen and is dropped
+static void tui_playlist_reset(yt_tui_t *tui)
+{
+    tui->playlist_base = UINT32_MAX;
+    tui->playlist_len = 0;
+    tui->stream_gen++;
+}
+
+static void tui_playback_stop(yt_tui_t *tui)
+{
+    // mpv's stop empties its playlist as well
+    if (tui->player_ready) { yt_player_stop(&tui->player); }
+
+    tui_playlist_reset(tui);
+
+    if (tui->render_active)
+    {
+        yt_render_shutdown(&tui->render);
+        tui->render_active = 0;
+    }
+
+    // vid=no outlives the file; the next play has to find its track again
+    if (tui->video_hidden)
+    {
+        yt_player_decode_set(&tui->player, 1);
+        tui->video_hidden = 0;
+    }
+
+    tui->pip_active = 0;
+}
+
+// kitty only; sixel and half-block output lives in the text grid and the feed would paint straight over it
+// audio only has nothing to shrink, it just keeps playing behind the feed
+static uint8_t tui_pip_enter(yt_tui_t *tui)
+{
+    if (tui->audio_only && tui->player_ready)
+    {
+        tui->pip_active = 1;
+        return 1;
+    }
+
+    if (!tui->render_active || tui->render.backend != YT_RENDER_BACKEND_KITTY) { return 0; }
+
+    uint32_t ret = tui_pip_place(tui);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK))
+    {
+        syslog(LOG_ERR, "tui_pip_enter; place failed; ret: %u", ret);
+        return 0;
+    }
+
+    // the small surface falls out of the box; the cap is what keeps the corner cheap
+    yt_render_fps_cap_set(&tui->render, YT_TUI_PIP_FPS);
+    tui->pip_active = 1;
+
+    return 1;
+}
+
+// back to full size; a renderer that cannot move is dropped and rebuilt by the caller
+static void tui_pip_leave(yt_tui_t *tui)
+{
+    if (!tui->pip_active) { return; }
+
+    tui->pip_active = 0;
+    if (!tui->render_active) { return; }
+
+    yt_feed_thumb_planes_destroy(&tui->feed);
+    ncplane_erase(tui->layout.content);
+    yt_render_fps_cap_set(&tui->render, 0);
+
+    uint32_t video_rows = 0;
+    uint32_t video_cols = 0;
+    tui_video_box_get(tui, &video_rows, &video_cols);
+
+    uint32_t ret = yt_render_reconfigure(&tui->render, tui->layout.content, video_rows, video_cols);
+    if (ret == LDG_ERR_AOK) { return; }
+
+    syslog(LOG_ERR, "tui_pip_leave; reconfigure failed; ret: %u", ret);
+    yt_render_shutdown(&tui->render);
+    tui->render_active = 0;
+}
+
 static uint32_t tui_player_ensure(yt_tui_t *tui)
 {
+    // autoplay keeps the corner; anything that opens the player view takes the video back
+    if (tui->pip_active && tui->current_view == YT_TUI_VIEW_PLAYER) { tui_pip_leave(tui); }
+
     if (!tui->player_ready)
     {
         uint32_t ret = yt_player_init(&tui->player);
         if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return ret; }
 
         tui->player_ready = 1;
+        if (tui->audio_only) { yt_player_video_set(&tui->player, 0); }
+    }
+
+    // audio only never starts a renderer; the player view is the text ui alone
+    if (tui->audio_only)
+    {
+        if (tui->current_view == YT_TUI_VIEW_PLAYER) { yt_feed_thumb_planes_destroy(&tui->feed); }
+
+        return LDG_ERR_AOK;
     }
 
     if (!tui->render_active)
@@ -315,14 +616,14 @@ static uint32_t tui_player_ensure(yt_tui_t *tui)
         yt_feed_thumb_planes_destroy(&tui->feed);
         ncplane_erase(tui->layout.content);
 
-        unsigned content_rows = 0;
-        unsigned content_cols = 0;
-        ncplane_dim_yx(tui->layout.content, &content_rows, &content_cols);
+        uint32_t video_rows = 0;
+        uint32_t video_cols = 0;
+        tui_video_box_get(tui, &video_rows, &video_cols);
 
-        uint32_t video_rows = (content_rows > YT_TUI_VIDEO_INFO_ROWS) ? content_rows - YT_TUI_VIDEO_INFO_ROWS : content_rows;
-        uint32_t video_cols = content_cols * 95 / 100;
+        yt_render_opts_t opts = LDG_STRUCT_ZERO_INIT;
+        tui_render_opts_build(tui, &opts);
 
-        uint32_t ret = yt_render_init(&tui->render, tui->player.mpv, tui->layout.content, video_rows, video_cols);
+        uint32_t ret = yt_render_init(&tui->render, tui->player.mpv, tui->layout.content, video_rows, video_cols, &opts);
         if (LDG_UNLIKELY(ret != LDG_ERR_AOK))
         {
             syslog(LOG_ERR, "tui_player_ensure; render init failed; ret: %u", ret);
@@ -330,11 +631,37 @@ static uint32_t tui_player_ensure(yt_tui_t *tui)
         }
 
         tui->render_active = 1;
+        if (tui->video_aspect > 0.0) { yt_render_aspect_set(&tui->render, tui->video_aspect); }
     }
 
     return LDG_ERR_AOK;
 }
 
+// settled resize; the live renderer is moved and refit, a full rebuild only if that fails
+static void tui_player_resize(yt_tui_t *tui)
+{
+    if (!tui->player_ready) { return; }
+
+    uint32_t video_rows = 0;
+    uint32_t video_cols = 0;
+    tui_video_box_get(tui, &video_rows, &video_cols);
+
+    if (tui->render_active)
+    {
+        uint32_t ret = tui->pip_active ? tui_pip_place(tui) : yt_render_reconfigure(&tui->render, tui->layout.content, video_rows, video_cols);
+        if (ret == LDG_ERR_AOK) { return; }
+
+        syslog(LOG_ERR, "tui_player_resize; reconfigure failed; ret: %u", ret);
+        yt_render_shutdown(&tui->render);
+        tui->render_active = 0;
+
+        // nothing left to show in the corner
+        if (tui->pip_active) { tui_playback_stop(tui); }
+    }
+
+    if (tui->current_view == YT_TUI_VIEW_PLAYER) { tui_player_ensure(tui); }
+}
+
 // load video by id
 static void tui_player_video_load(yt_tui_t *tui, const char *video_id)
 {
@@ -347,6 +674,381 @@ static void tui_player_video_load(yt_tui_t *tui, const char *video_id)
     yt_player_load(&tui->player, url);
 }
 
+// resolved streams for a video, 0x0 when neither slot has them
+static yt_tui_stream_t* tui_stream_slot_find(yt_tui_t *tui, const char *video_id)
+{
+    uint32_t i = 0;
+    for (; i < YT_TUI_STREAM_SLOTS; i++)
+    {
+        if (tui->streams[i].video_id[0] != '\0' && strcmp(tui->streams[i].video_id, video_id) == 0) { return &tui->streams[i]; }
+    }
+
+    return 0x0;
+}
+
+// what the renderer draws into; the largest surface it could ever use until it runs
+static void tui_stream_target_get(yt_tui_t *tui, uint32_t *w, uint32_t *h)
+{
+    *w = YT_RENDER_MAX_W;
+    *h = YT_RENDER_MAX_H;
+    if (!tui->render_active) { return; }
+
+    uint32_t surf_w = 0;
+    uint32_t surf_h = 0;
+    yt_render_surface_get(&tui->render, &surf_w, &surf_h);
+    if (surf_w == 0 || surf_h == 0) { return; }
+
+    *w = surf_w;
+    *h = surf_h;
+}
+
+// the url for an item in the format that fits the mode and surface now; mpv's ytdl hook when nothing resolved
+static void tui_stream_url_get(yt_tui_t *tui, uint32_t idx, yt_tui_stream_t *slot, char *url, size_t url_len)
+{
+    uint32_t ret = YT_ERR_PLAYER_NO_STREAM;
+    if (slot)
+    {
+        tui_stream_target_get(tui, &slot->target_w, &slot->target_h);
+        if (tui->audio_only) { ret = yt_stream_pick_audio(&slot->set, &slot->pick); }
+        else { ret = yt_stream_pick(&slot->set, slot->target_w, slot->target_h, &slot->pick); }
+
+        if (ret == LDG_ERR_AOK) { ret = yt_stream_url_build(&slot->set, &slot->pick, url, url_len); }
+    }
+
+    if (ret != LDG_ERR_AOK)
+    {
+        syslog(LOG_INFO, "tui_stream_url_get; no resolved stream, using ytdl hook; idx: %u; ret: %u", idx, ret);
+        snprintf(url, url_len, "https://www.youtube.com/watch?v=%s", tui->queue.items[idx].id);
+        return;
+    }
+
+    if (slot->pick.video_idx >= slot->set.stream_cunt)
+    {
+        const yt_stream_t *audio = &slot->set.streams[slot->pick.audio_idx];
+        syslog(LOG_INFO, "tui_stream_url_get; idx: %u; audio itag: %u; bitrate: %u", idx, audio->itag, audio->bitrate);
+        return;
+    }
+
+    const yt_stream_t *video = &slot->set.streams[slot->pick.video_idx];
+    syslog(LOG_INFO, "tui_stream_url_get; idx: %u; itag: %u; %ux%u@%u; target: %ux%u", idx, video->itag, video->width, video->height, video->fps, slot->target_w, slot->target_h);
+}
+
+// an item onto the end of the window
+static void tui_stream_load(yt_tui_t *tui, uint32_t idx, yt_tui_stream_t *slot)
+{
+    char url[YT_STREAM_EDL_MAX] = LDG_ARR_ZERO_INIT;
+    tui_stream_url_get(tui, idx, slot, url, sizeof(url));
+
+    // the first entry replaces whatever played before the window was rebuilt
+    uint32_t ret = (tui->playlist_len == 0) ? yt_player_load(&tui->player, url) : yt_player_append(&tui->player, url);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK))
+    {
+        syslog(LOG_ERR, "tui_stream_load; load failed; idx: %u; ret: %u", idx, ret);
+        tui_playlist_reset(tui);
+        return;
+    }
+
+    tui->playlist_len++;
+}
+
+// a resolve onto the pool; the result comes back on result_q
+static uint32_t tui_stream_resolve_submit(yt_tui_t *tui, const char *video_id, uint32_t idx, ldg_spsc_queue_t *result_q)
+{
+    tui_stream_task_ctx_t *ctx = (tui_stream_task_ctx_t *)malloc(sizeof(tui_stream_task_ctx_t));
+    if (LDG_UNLIKELY(!ctx)) { return LDG_ERR_ALLOC_NULL; }
+
+    memset(ctx, 0, sizeof(*ctx));
+    snprintf(ctx->access_token, sizeof(ctx->access_token), "%s", tui->token.access);
+    snprintf(ctx->video_id, sizeof(ctx->video_id), "%s", video_id);
+    if (tui->conf->stream_cache_disk) { snprintf(ctx->cache_dir, sizeof(ctx->cache_dir), "%s", tui->conf->cache_dir); }
+
+    ctx->idx = idx;
+    ctx->gen = tui->stream_gen;
+    ctx->result_q = result_q;
+
+    uint32_t ret = ldg_thread_pool_submit(&tui->pool, stream_resolve_task, ctx);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { free(ctx); }
+
+    return ret;
+}
+
+// a cached set copied into the item's slot, 0x0 on a miss
+static yt_tui_stream_t* tui_stream_cache_take(yt_tui_t *tui, uint32_t idx)
+{
+    const yt_stream_set_t *set = yt_stream_cache_get(&tui->stream_cache, tui->queue.items[idx].id, (uint64_t)time(0x0));
+    if (!set) { return 0x0; }
+
+    yt_tui_stream_t *slot = &tui->streams[idx % YT_TUI_STREAM_SLOTS];
+    memcpy(&slot->set, set, sizeof(slot->set));
+    snprintf(slot->video_id, sizeof(slot->video_id), "%s", tui->queue.items[idx].id);
+
+    return slot;
+}
+
+// fill the window up to the item after the playing one; streams still in a slot or the cache skip the resolve
+static void tui_stream_pump(yt_tui_t *tui)
+{
+    while (tui->playlist_base != UINT32_MAX && !tui->stream_req_pending)
+    {
+        uint32_t idx = tui->playlist_base + tui->playlist_len;
+        if (idx >= tui->queue.cunt) { return; }
+
+        if (tui->playlist_len > 0 && idx > tui->queue.current_idx + 1) { return; }
+
+        yt_tui_stream_t *slot = tui_stream_slot_find(tui, tui->queue.items[idx].id);
+        if (!slot) { slot = tui_stream_cache_take(tui, idx); }
+
+        if (slot)
+        {
+            tui_stream_load(tui, idx, slot);
+            continue;
+        }
+
+        // already on its way from the hover; it lands in the cache and pumps again
+        if (tui->spec_req_id[0] != '\0' && strcmp(tui->spec_req_id, tui->queue.items[idx].id) == 0) { return; }
+
+        uint32_t ret = tui_stream_resolve_submit(tui, tui->queue.items[idx].id, idx, &tui->stream_result_q);
+        if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return; }
+
+        tui->stream_req_pending = 1;
+    }
+}
+
+// the feed item under the cursor gets resolved into the cache once it has been there a moment, so enter starts
+// right away; the pool has one queue, so this waits for playback resolves and keeps to one in flight
+static void tui_stream_speculate(yt_tui_t *tui, uint64_t now_ns)
+{
+    if (tui->current_view != YT_TUI_VIEW_FEED) { return; }
+
+    const yt_video_t *vid = yt_feed_selected_get(&tui->feed);
+    if (!vid || vid->id[0] == '\0') { return; }
+
+    if (strcmp(vid->id, tui->spec_hover_id) != 0)
+    {
+        snprintf(tui->spec_hover_id, sizeof(tui->spec_hover_id), "%s", vid->id);
+        tui->spec_hover_ns = now_ns;
+        tui->spec_tried = 0;
+        return;
+    }
+
+    if (tui->spec_tried || now_ns - tui->spec_hover_ns < YT_TUI_SPEC_DWELL_NS) { return; }
+
+    if (tui->stream_req_pending || tui->spec_req_id[0] != '\0') { return; }
+
+    tui->spec_tried = 1;
+    if (tui_stream_slot_find(tui, vid->id) || yt_stream_cache_get(&tui->stream_cache, vid->id, (uint64_t)time(0x0))) { return; }
+
+    uint32_t ret = tui_stream_resolve_submit(tui, vid->id, UINT32_MAX, &tui->spec_result_q);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return; }
+
+    snprintf(tui->spec_req_id, sizeof(tui->spec_req_id), "%s", vid->id);
+}
+
+// a resolve for the end of the window; the playing item and the next never share a slot
+static void tui_stream_result_apply(yt_tui_t *tui, const tui_stream_result_t *result)
+{
+    yt_tui_stream_t *slot = &tui->streams[result->idx % YT_TUI_STREAM_SLOTS];
+    if (result->err != LDG_ERR_AOK)
+    {
+        slot->video_id[0] = '\0';
+        tui_stream_load(tui, result->idx, 0x0);
+        return;
+    }
+
+    memcpy(&slot->set, &result->streams, sizeof(slot->set));
+    snprintf(slot->video_id, sizeof(slot->video_id), "%s", result->video_id);
+    yt_stream_cache_put(&tui->stream_cache, result->video_id, &result->streams, (uint64_t)time(0x0));
+    tui_stream_load(tui, result->idx, slot);
+}
+
+// the playing item reloaded from url where it was; replace drops mpv's playlist, so the window starts over at it
+static uint32_t tui_stream_swap(yt_tui_t *tui, const char *url, double time_pos)
+{
+    uint32_t ret = yt_player_load_at(&tui->player, url, time_pos);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return ret; }
+
+    uint32_t idx = tui->queue.current_idx;
+    tui_playlist_reset(tui);
+    tui->playlist_base = idx;
+    tui->playlist_len = 1;
+    tui_stream_pump(tui);
+
+    return LDG_ERR_AOK;
+}
+
+// the surface moved (resize, pip, governor); once it holds still, swap the playing item to the format that fits
+// it, resuming where it was; the rebuilt window takes the next item from its slot in the new format too
+static void tui_stream_reselect(yt_tui_t *tui, uint64_t now_ns)
+{
+    if (!tui->render_active || tui->playlist_base == UINT32_MAX || tui->playlist_len == 0) { return; }
+
+    uint32_t w = 0;
+    uint32_t h = 0;
+    tui_stream_target_get(tui, &w, &h);
+    if (w != tui->stream_target_w || h != tui->stream_target_h)
+    {
+        tui->stream_target_w = w;
+        tui->stream_target_h = h;
+        tui->stream_target_ns = now_ns;
+        return;
+    }
+
+    if (now_ns - tui->stream_target_ns < YT_TUI_RESELECT_SETTLE_NS) { return; }
+
+    if (tui->queue.current_idx >= tui->queue.cunt) { return; }
+
+    yt_tui_stream_t *slot = tui_stream_slot_find(tui, tui->queue.items[tui->queue.current_idx].id);
+    if (!slot || (slot->target_w == w && slot->target_h == h)) { return; }
+
+    yt_stream_pick_t pick = LDG_STRUCT_ZERO_INIT;
+    uint32_t ret = yt_stream_pick(&slot->set, w, h, &pick);
+    uint8_t worth = (ret == LDG_ERR_AOK) && yt_stream_switch_worth(&slot->set, &slot->pick, &pick, w, h);
+    slot->target_w = w;
+    slot->target_h = h;
+    if (!worth) { return; }
+
+    char url[YT_STREAM_EDL_MAX] = LDG_ARR_ZERO_INIT;
+    ret = yt_stream_url_build(&slot->set, &pick, url, sizeof(url));
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return; }
+
+    double pos = 0.0;
+    yt_player_time_pos_get(&tui->player, &pos);
+
+    const yt_stream_t *from = &slot->set.streams[slot->pick.video_idx];
+    const yt_stream_t *to = &slot->set.streams[pick.video_idx];
+    syslog(LOG_INFO, "tui_stream_reselect; itag: %u -> %u; %ux%u -> %ux%u; target: %ux%u; at: %.3f", from->itag, to->itag, from->width, from->height, to->width, to->height, w, h, pos);
+
+    slot->pick = pick;
+    tui_stream_swap(tui, url, pos);
+}
+
+// audio only and video swap for everything played from here on; the playing item reloads in the new mode where it was
+// vid=no already stops decoding, the reload is what stops the video download
+static void tui_audio_toggle(yt_tui_t *tui)
+{
+    tui->audio_only = !tui->audio_only;
+    syslog(LOG_INFO, "tui_audio_toggle; audio_only: %u", tui->audio_only);
+    if (!tui->player_ready) { return; }
+
+    yt_player_video_set(&tui->player, !tui->audio_only);
+    tui->video_hidden = 0;
+    if (tui->audio_only && tui->render_active)
+    {
+        yt_render_shutdown(&tui->render);
+        tui->render_active = 0;
+        ncplane_erase(tui->layout.content);
+    }
+
+    if (tui->playlist_base == UINT32_MAX || tui->playlist_len == 0 || tui->queue.current_idx >= tui->queue.cunt) { return; }
+
+    // a video needs somewhere to go; a corner it could not be shrunk into would stop playback, so take the player view
+    if (!tui->audio_only)
+    {
+        tui->current_view = YT_TUI_VIEW_PLAYER;
+        uint32_t ret = tui_player_ensure(tui);
+        if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return; }
+    }
+
+    double pos = 0.0;
+    yt_player_time_pos_get(&tui->player, &pos);
+
+    uint32_t idx = tui->queue.current_idx;
+    char url[YT_STREAM_EDL_MAX] = LDG_ARR_ZERO_INIT;
+    tui_stream_url_get(tui, idx, tui_stream_slot_find(tui, tui->queue.items[idx].id), url, sizeof(url));
+    tui_stream_swap(tui, url, pos);
+}
+
+// video is only decoded while something shows it, the player view or the feed's corner; behind the queue or search
+// the track goes off and the renderer with it, so background playback costs about what audio only does
+static void tui_video_visibility_sync(yt_tui_t *tui)
+{
+    if (!tui->player_ready || tui->audio_only) { return; }
+
+    uint8_t hidden = tui->pip_active && tui->current_view != YT_TUI_VIEW_FEED && tui->current_view != YT_TUI_VIEW_PLAYER;
+    if (hidden == tui->video_hidden) { return; }
+
+    if (hidden)
+    {
+        yt_player_decode_set(&tui->player, 0);
+        if (tui->render_active)
+        {
+            yt_render_shutdown(&tui->render);
+            tui->render_active = 0;
+        }
+
+        tui->video_hidden = 1;
+        return;
+    }
+
+    // the player view rebuilt its renderer on the way in; the corner is rebuilt here
+    if (tui->current_view == YT_TUI_VIEW_FEED && !tui->render_active)
+    {
+        uint32_t ret = tui_player_ensure(tui);
+        if (ret != LDG_ERR_AOK || !tui_pip_enter(tui))
+        {
+            tui_playback_stop(tui);
+            return;
+        }
+    }
+
+    yt_player_decode_set(&tui->player, 1);
+    tui->video_hidden = 0;
+}
+
+// mpv's playlist mirrors queue[playlist_base..playlist_base + playlist_len); with the next item resolved and appended
+// ahead of time, prefetch-playlist has it open when this one ends
+// anything inside the window is a jump; anything else rebuilds the window from idx
+static void tui_queue_play(yt_tui_t *tui, uint32_t idx)
+{
+    if (idx >= tui->queue.cunt) { return; }
+
+    uint32_t ret = tui_player_ensure(tui);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return; }
+
+    tui->queue.current_idx = idx;
+    if (tui->playlist_base != UINT32_MAX && idx >= tui->playlist_base && idx - tui->playlist_base < tui->playlist_len)
+    {
+        ret = yt_player_playlist_play(&tui->player, idx - tui->playlist_base);
+        if (ret == LDG_ERR_AOK) { return; }
+    }
+
+    // whatever plays now keeps going until the resolved item replaces it
+    tui_playlist_reset(tui);
+    tui->playlist_base = idx;
+    tui_stream_pump(tui);
+}
+
+// index of the pushed video, UINT32_MAX when the queue is full
+static uint32_t tui_queue_push(yt_tui_t *tui, const yt_video_t *vid)
+{
+    uint32_t ret = yt_queue_push(&tui->queue, vid);
+    if (LDG_UNLIKELY(ret != LDG_ERR_AOK)) { return UINT32_MAX; }
+
+    tui_stream_pump(tui);
+
+    return tui->queue.cunt - 1;
+}
+
+// the playing video keeps its place in mpv; everything after it is dropped and resolved again in the new order
+static void tui_queue_shuffle(yt_tui_t *tui)
+{
+    yt_queue_shuffle(&tui->queue);
+    if (tui->playlist_base == UINT32_MAX) { return; }
+
+    if (LDG_UNLIKELY(tui->queue.current_idx >= tui->queue.cunt)) { return; }
+
+    uint32_t len = tui->playlist_len;
+    tui_playlist_reset(tui);
+    if (len > 0)
+    {
+        yt_player_playlist_trim(&tui->player);
+        tui->playlist_len = 1;
+    }
+
+    tui->playlist_base = tui->queue.current_idx;
+    tui_stream_pump(tui);
+}
+
 // input handlers
 static void tui_feed_handle(yt_tui_t *tui, yt_action_t action)
 {
@@ -364,12 +1066,25 @@ static void tui_feed_handle(yt_tui_t *tui, yt_action_t action)
         case YT_ACTION_NEXT:
         case YT_ACTION_PREV:
         case YT_ACTION_SHUFFLE:
+        case YT_ACTION_STATS:
+        case YT_ACTION_AUDIO:
             break;
 
         case YT_ACTION_RIGHT:
             tui->current_view = YT_TUI_VIEW_QUEUE;
             break;
 
+        case YT_ACTION_PLAYER:
+            if (!tui->pip_active) { break; }
+
+            tui->current_view = YT_TUI_VIEW_PLAYER;
+            tui_player_ensure(tui);
+            break;
+
+        case YT_ACTION_STOP:
+            tui_playback_stop(tui);
+            break;
+
         case YT_ACTION_UP:
             yt_feed_nav_up(&tui->feed);
             break;
@@ -383,9 +1098,15 @@ static void tui_feed_handle(yt_tui_t *tui, yt_action_t action)
             const yt_video_t *vid = yt_feed_selected_get(&tui->feed);
             if (vid)
             {
-                yt_queue_push(&tui->queue, vid);
                 tui->current_view = YT_TUI_VIEW_PLAYER;
-                tui_player_video_load(tui, vid->id);
+                uint32_t idx = tui_queue_push(tui, vid);
+                if (idx != UINT32_MAX) { tui_queue_play(tui, idx); }
+                else
+                {
+                    // full queue; played on its own, outside the mirror
+                    tui_playlist_reset(tui);
+                    tui_player_video_load(tui, vid->id);
+                }
             }
 
             break;
@@ -394,7 +1115,7 @@ static void tui_feed_handle(yt_tui_t *tui, yt_action_t action)
         case YT_ACTION_QUEUE_ADD:
         {
             const yt_video_t *vid = yt_feed_selected_get(&tui->feed);
-            if (vid) { yt_queue_push(&tui->queue, vid); }
+            if (vid) { tui_queue_push(tui, vid); }
 
             break;
         }
@@ -430,15 +1151,24 @@ static void tui_player_handle(yt_tui_t *tui, yt_action_t action)
         case YT_ACTION_SEARCH:
         case YT_ACTION_QUEUE_ADD:
         case YT_ACTION_REFRESH:
+        case YT_ACTION_PLAYER:
+            break;
+
+        case YT_ACTION_STATS:
+            tui->stats_visible = !tui->stats_visible;
+            break;
+
+        case YT_ACTION_AUDIO:
+            tui_audio_toggle(tui);
             break;
 
         case YT_ACTION_PAUSE:
         {
             if (!tui->player_ready) { break; }
 
-            int paused = 0;
-            mpv_get_property(tui->player.mpv, "pause", MPV_FORMAT_FLAG, &paused);
-            if (paused) { yt_player_resume(&tui->player); }
+            yt_player_snap_t snap = LDG_STRUCT_ZERO_INIT;
+            yt_player_snap_get(&tui->player, &snap);
+            if (snap.paused) { yt_player_resume(&tui->player); }
             else { yt_player_pause(&tui->player); }
 
             break;
@@ -458,9 +1188,9 @@ static void tui_player_handle(yt_tui_t *tui, yt_action_t action)
         {
             if (!tui->player_ready) { break; }
 
-            double vol = 0.0;
-            mpv_get_property(tui->player.mpv, "volume", MPV_FORMAT_DOUBLE, &vol);
-            vol += YT_TUI_VOL_STEP;
+            yt_player_snap_t snap = LDG_STRUCT_ZERO_INIT;
+            yt_player_snap_get(&tui->player, &snap);
+            double vol = (double)snap.volume + YT_TUI_VOL_STEP;
             if (vol > 150.0) { vol = 150.0; }
 
             yt_player_volume_set(&tui->player, (uint32_t)vol);
@@ -471,9 +1201,9 @@ static void tui_player_handle(yt_tui_t *tui, yt_action_t action)
         {
             if (!tui->player_ready) { break; }
 
-            double vol = 0.0;
-            mpv_get_property(tui->player.mpv, "volume", MPV_FORMAT_DOUBLE, &vol);
-            vol -= YT_TUI_VOL_STEP;
+            yt_player_snap_t snap = LDG_STRUCT_ZERO_INIT;
+            yt_player_snap_get(&tui->player, &snap);
+            double vol = (double)snap.volume - YT_TUI_VOL_STEP;
             if (vol < 0.0) { vol = 0.0; }
 
             yt_player_volume_set(&tui->player, (uint32_t)vol);
@@ -483,11 +1213,7 @@ static void tui_player_handle(yt_tui_t *tui, yt_action_t action)
         case YT_ACTION_NEXT:
         {
             uint32_t ret = yt_queue_next(&tui->queue);
-            if (ret == LDG_ERR_AOK)
-            {
-                const yt_video_t *vid = yt_queue_current_get(&tui->queue);
-                if (vid) { tui_player_video_load(tui, vid->id); }
-            }
+            if (ret == LDG_ERR_AOK) { tui_queue_play(tui, tui->queue.current_idx); }
 
             break;
         }
@@ -495,28 +1221,24 @@ static void tui_player_handle(yt_tui_t *tui, yt_action_t action)
         case YT_ACTION_PREV:
         {
             uint32_t ret = yt_queue_prev(&tui->queue);
-            if (ret == LDG_ERR_AOK)
-            {
-                const yt_video_t *vid = yt_queue_current_get(&tui->queue);
-                if (vid) { tui_player_video_load(tui, vid->id); }
-            }
+            if (ret == LDG_ERR_AOK) { tui_queue_play(tui, tui->queue.current_idx); }
 
             break;
         }
 
         case YT_ACTION_SHUFFLE:
-            yt_queue_shuffle(&tui->queue);
+            tui_queue_shuffle(tui);
             break;
 
+        // playback carries on in the corner while the feed is browsed
         case YT_ACTION_BACK:
-            if (tui->player_ready) { yt_player_stop(&tui->player); }
+            if (!tui_pip_enter(tui)) { tui_playback_stop(tui); }
 
-            if (tui->render_active)
-            {
-                yt_render_shutdown(&tui->render);
-                tui->render_active = 0;
-            }
+            tui->current_view = YT_TUI_VIEW_FEED;
+            break;
 
+        case YT_ACTION_STOP:
+            tui_playback_stop(tui);
             tui->current_view = YT_TUI_VIEW_FEED;
             break;
 
@@ -541,6 +1263,22 @@ static void tui_queue_handle(yt_tui_t *tui, yt_action_t action)
         case YT_ACTION_QUEUE_ADD:
         case YT_ACTION_REFRESH:
         case YT_ACTION_SEARCH:
+        case YT_ACTION_STATS:
+            break;
+
+        case YT_ACTION_AUDIO:
+            tui_audio_toggle(tui);
+            break;
+
+        case YT_ACTION_PLAYER:
+            if (!tui->pip_active) { break; }
+
+            tui->current_view = YT_TUI_VIEW_PLAYER;
+            tui_player_ensure(tui);
+            break;
+
+        case YT_ACTION_STOP:
+            tui_playback_stop(tui);
             break;
 
         case YT_ACTION_UP:
@@ -557,10 +1295,8 @@ static void tui_queue_handle(yt_tui_t *tui, yt_action_t action)
         {
             if (tui->queue.selected_idx < tui->queue.cunt)
             {
-                tui->queue.current_idx = tui->queue.selected_idx;
                 tui->current_view = YT_TUI_VIEW_PLAYER;
-                const yt_video_t *vid = yt_queue_current_get(&tui->queue);
-                if (vid) { tui_player_video_load(tui, vid->id); }
+                tui_queue_play(tui, tui->queue.selected_idx);
             }
 
             break;
@@ -572,8 +1308,7 @@ static void tui_queue_handle(yt_tui_t *tui, yt_action_t action)
             if (ret == LDG_ERR_AOK)
             {
                 tui->current_view = YT_TUI_VIEW_PLAYER;
-                const yt_video_t *vid = yt_queue_current_get(&tui->queue);
-                if (vid) { tui_player_video_load(tui, vid->id); }
+                tui_queue_play(tui, tui->queue.current_idx);
             }
 
             break;
@@ -585,15 +1320,14 @@ static void tui_queue_handle(yt_tui_t *tui, yt_action_t action)
             if (ret == LDG_ERR_AOK)
             {
                 tui->current_view = YT_TUI_VIEW_PLAYER;
-                const yt_video_t *vid = yt_queue_current_get(&tui->queue);
-                if (vid) { tui_player_video_load(tui, vid->id); }
+                tui_queue_play(tui, tui->queue.current_idx);
             }
 
             break;
         }
 
         case YT_ACTION_SHUFFLE:
-            yt_queue_shuffle(&tui->queue);
+            tui_queue_shuffle(tui);
             break;
 
         case YT_ACTION_BACK:
@@ -705,13 +1439,36 @@ static void tui_feed_render(yt_tui_t *tui)
     yt_feed_render(&tui->feed, tui->layout.content);
 
     char status_msg[128] = LDG_ARR_ZERO_INIT;
-    snprintf(status_msg, sizeof(status_msg), "videos: %u | q:quit j/k:nav enter:play a:queue l:queue r:refresh /:search", tui->feed.feed.video_cunt);
+    snprintf(status_msg, sizeof(status_msg), "videos: %u | q:quit j/k:nav enter:play a:queue l:queue r:refresh /:search%s", tui->feed.feed.video_cunt, tui->pip_active ? " v:player x:stop" : "");
     yt_layout_status_render(&tui->layout, status_msg);
 }
 
+// p50 / p99 / max per stage in ms, in place of the video info rows
+static void tui_stats_render(yt_tui_t *tui, uint32_t info_y)
+{
+    static const char *const stage_names[YT_RENDER_STAGE_CUNT] = { "render", "post", "write", "e2e" };
+
+    if (yt_render_stats_get(&tui->render, &tui->render_stats) != LDG_ERR_AOK) { return; }
+
+    const yt_render_stats_t *stats = &tui->render_stats;
+    ncplane_set_fg_rgb8(tui->layout.content, 0, 180, 180);
+
+    uint32_t s = 0;
+    for (; s < YT_RENDER_STAGE_CUNT; s++)
+    {
+        const yt_hist_t *hist = &stats->stage[s];
+        int y = (int)(info_y + s / 2);
+        int x = (s % 2 == 0) ? 2 : 40;
+        ncplane_printf_yx(tui->layout.content, y, x, "%-6s %6.2f %6.2f %6.2f ms", stage_names[s], (double)yt_hist_pct(hist, 500) / 1e6, (double)yt_hist_pct(hist, 990) / 1e6, (double)hist->max / 1e6);
+    }
+
+    ncplane_set_fg_rgb8(tui->layout.content, 150, 150, 150);
+    ncplane_printf_yx(tui->layout.content, (int)(info_y + 2), 2, "frames %lu  drop %lu  dup %lu  delta %lu  (p50 p99 max)", (unsigned long)stats->frame_cunt, (unsigned long)stats->drop_cunt, (unsigned long)stats->dup_cunt, (unsigned long)stats->delta_cunt);
+}
+
 static void tui_player_render(yt_tui_t *tui)
 {
-    yt_layout_header_render(&tui->layout, "player");
+    yt_layout_header_render(&tui->layout, tui->audio_only ? "player | audio only" : "player");
 
     unsigned content_rows = 0;
     unsigned content_cols = 0;
@@ -720,11 +1477,19 @@ static void tui_player_render(yt_tui_t *tui)
     uint32_t video_rows = (content_rows > YT_TUI_VIDEO_INFO_ROWS) ? content_rows - YT_TUI_VIDEO_INFO_ROWS : content_rows;
     uint32_t info_y = video_rows;
 
-    uint32_t r = info_y;
-    for (; r < content_rows; r++) { ncplane_putstr_yx(tui->layout.content, (int)r, 0, ""); }
+    // no video underneath; the info rows move to the top of an otherwise empty plane
+    if (tui->audio_only)
+    {
+        ncplane_erase(tui->layout.content);
+        info_y = 1;
+    }
+
+    // the info rows switch between video info and stats; clear whatever the other left behind
+    if (content_rows > info_y) { ncplane_erase_region(tui->layout.content, (int)info_y, 0, (int)(content_rows - info_y), (int)content_cols); }
 
     const yt_video_t *current = yt_queue_current_get(&tui->queue);
-    if (current)
+    if (tui->stats_visible && tui->render_active) { tui_stats_render(tui, info_y); }
+    else if (current)
     {
         ncplane_set_fg_rgb8(tui->layout.content, 220, 220, 220);
         ncplane_putstr_yx(tui->layout.content, (int)info_y, 2, current->title);
@@ -740,17 +1505,13 @@ static void tui_player_render(yt_tui_t *tui)
 
         if (tui->player_ready)
         {
-            double pos = 0.0;
-            double dur = 0.0;
-            double vol = 0.0;
-            int paused = 0;
-            mpv_get_property(tui->player.mpv, "time-pos", MPV_FORMAT_DOUBLE, &pos);
-            mpv_get_property(tui->player.mpv, "duration", MPV_FORMAT_DOUBLE, &dur);
-            mpv_get_property(tui->player.mpv, "volume", MPV_FORMAT_DOUBLE, &vol);
-            mpv_get_property(tui->player.mpv, "pause", MPV_FORMAT_FLAG, &paused);
+            yt_player_snap_t snap = LDG_STRUCT_ZERO_INIT;
+            yt_player_snap_get(&tui->player, &snap);
+            double pos = snap.time_pos;
+            double dur = snap.duration;
 
             // progress bar
-            uint32_t bar_w = (content_cols > 40) ? content_cols - 40 : 10;
+            uint32_t bar_w = (content_cols > 62) ? content_cols - 52 : 10;
             uint32_t filled = 0;
             if (dur > 0.0) { filled = (uint32_t)((pos / dur) * (double)bar_w); }
 
@@ -762,7 +1523,8 @@ static void tui_player_render(yt_tui_t *tui)
             bar[bi] = '\0';
 
             ncplane_set_fg_rgb8(tui->layout.content, 180, 180, 0);
-            ncplane_printf_yx(tui->layout.content, (int)(info_y + 2), 2, "%s  %02u:%02u / %02u:%02u  [%s]  vol: %u%%", paused ? "paused " : "playing", (uint32_t)pos / 60, (uint32_t)pos % 60, (uint32_t)dur / 60, (uint32_t)dur % 60, bar, (uint32_t)vol);
+            const char *state_str = snap.buffering ? "buffer " : (snap.paused ? "paused " : "playing");
+            ncplane_printf_yx(tui->layout.content, (int)(info_y + 2), 2, "%s  %02u:%02u / %02u:%02u  [%s]  vol: %u%%  cache: %us", state_str, (uint32_t)pos / 60, (uint32_t)pos % 60, (uint32_t)dur / 60, (uint32_t)dur % 60, bar, snap.volume, (uint32_t)snap.cache_secs);
         }
         else
         {
@@ -776,7 +1538,7 @@ static void tui_player_render(yt_tui_t *tui)
         ncplane_putstr_yx(tui->layout.content, (int)info_y, 2, "no video selected");
     }
 
-    yt_layout_status_render(&tui->layout, "space:pause </>:seek +/-:vol n/p:next/prev esc:back");
+    yt_layout_status_render(&tui->layout, tui->audio_only ? "space:pause </>:seek +/-:vol n/p:next/prev o:video x:stop esc:back" : "space:pause </>:seek +/-:vol n/p:next/prev i:stats o:audio x:stop esc:pip");
 
     if (tui->render_active)
     {
@@ -784,7 +1546,7 @@ static void tui_player_render(yt_tui_t *tui)
         unsigned status_cols = 0;
         ncplane_dim_yx(tui->layout.status, &status_rows, &status_cols);
         ncplane_set_fg_rgb8(tui->layout.status, 100, 100, 100);
-        ncplane_printf_yx(tui->layout.status, 0, (int)(status_cols - 22), "%ux%u %u fps", tui->render.pixel_w, tui->render.pixel_h, tui->render.fps);
+        ncplane_printf_yx(tui->layout.status, 0, (int)(status_cols - 34), "%ux%u %u fps %lu drop", tui->render.pixel_w, tui->render.pixel_h, tui->render.fps, (unsigned long)tui->render.drop_cunt);
     }
 }
 
@@ -811,7 +1573,7 @@ static void tui_queue_render(yt_tui_t *tui)
     yt_queue_render(&tui->queue, tui->layout.content);
 
     char status_msg[128] = LDG_ARR_ZERO_INIT;
-    snprintf(status_msg, sizeof(status_msg), "tracks: %u | j/k:nav enter:play s:shuffle esc:back", tui->queue.cunt);
+    snprintf(status_msg, sizeof(status_msg), "tracks: %u | j/k:nav enter:play s:shuffle o:%s esc:back%s", tui->queue.cunt, tui->audio_only ? "video" : "audio", tui->pip_active ? " v:player x:stop" : "");
     yt_layout_status_render(&tui->layout, status_msg);
 }
 
@@ -824,6 +1586,8 @@ uint32_t yt_tui_init(yt_tui_t *tui, yt_conf_t *conf)
 
     memset(tui, 0, sizeof(*tui));
     tui->conf = conf;
+    tui->playlist_base = UINT32_MAX;
+    tui->audio_only = (conf->audio_only != 0);
 
     tui_term_reset();
     signal(SIGINT, tui_signal_cleanup);
@@ -873,9 +1637,22 @@ uint32_t yt_tui_init(yt_tui_t *tui, yt_conf_t *conf)
         return err;
     }
 
-    err = ldg_spsc_init(&tui->stream_result_q, sizeof(yt_stream_set_t), 4);
+    err = ldg_spsc_init(&tui->stream_result_q, sizeof(tui_stream_result_t), 4);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+    {
+        ldg_spsc_shutdown(&tui->auth_result_q);
+        ldg_spsc_shutdown(&tui->api_result_q);
+        ldg_thread_pool_shutdown(&tui->pool);
+        yt_layout_shutdown(&tui->layout);
+        notcurses_stop(tui->nc);
+        tui->nc = 0x0;
+        return err;
+    }
+
+    err = ldg_spsc_init(&tui->spec_result_q, sizeof(tui_stream_result_t), 2);
     if (LDG_UNLIKELY(err != LDG_ERR_AOK))
     {
+        ldg_spsc_shutdown(&tui->stream_result_q);
         ldg_spsc_shutdown(&tui->auth_result_q);
         ldg_spsc_shutdown(&tui->api_result_q);
         ldg_thread_pool_shutdown(&tui->pool);
@@ -888,6 +1665,7 @@ uint32_t yt_tui_init(yt_tui_t *tui, yt_conf_t *conf)
     err = ldg_spsc_init(&tui->thumb_result_q, sizeof(tui_thumb_result_t), 32);
     if (LDG_UNLIKELY(err != LDG_ERR_AOK))
     {
+        ldg_spsc_shutdown(&tui->spec_result_q);
         ldg_spsc_shutdown(&tui->stream_result_q);
         ldg_spsc_shutdown(&tui->auth_result_q);
         ldg_spsc_shutdown(&tui->api_result_q);
@@ -902,6 +1680,40 @@ uint32_t yt_tui_init(yt_tui_t *tui, yt_conf_t *conf)
     if (LDG_UNLIKELY(err != LDG_ERR_AOK))
     {
         ldg_spsc_shutdown(&tui->thumb_result_q);
+        ldg_spsc_shutdown(&tui->spec_result_q);
+        ldg_spsc_shutdown(&tui->stream_result_q);
+        ldg_spsc_shutdown(&tui->auth_result_q);
+        ldg_spsc_shutdown(&tui->api_result_q);
+        ldg_thread_pool_shutdown(&tui->pool);
+        yt_layout_shutdown(&tui->layout);
+        notcurses_stop(tui->nc);
+        tui->nc = 0x0;
+        return err;
+    }
+
+    err = yt_stream_cache_init(&tui->stream_cache, conf->stream_cache_max);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+    {
+        yt_feed_ctx_shutdown(&tui->feed);
+        ldg_spsc_shutdown(&tui->thumb_result_q);
+        ldg_spsc_shutdown(&tui->spec_result_q);
+        ldg_spsc_shutdown(&tui->stream_result_q);
+        ldg_spsc_shutdown(&tui->auth_result_q);
+        ldg_spsc_shutdown(&tui->api_result_q);
+        ldg_thread_pool_shutdown(&tui->pool);
+        yt_layout_shutdown(&tui->layout);
+        notcurses_stop(tui->nc);
+        tui->nc = 0x0;
+        return err;
+    }
+
+    err = yt_output_init(&tui->output);
+    if (LDG_UNLIKELY(err != LDG_ERR_AOK))
+    {
+        yt_stream_cache_shutdown(&tui->stream_cache);
+        yt_feed_ctx_shutdown(&tui->feed);
+        ldg_spsc_shutdown(&tui->thumb_result_q);
+        ldg_spsc_shutdown(&tui->spec_result_q);
         ldg_spsc_shutdown(&tui->stream_result_q);
         ldg_spsc_shutdown(&tui->auth_result_q);
         ldg_spsc_shutdown(&tui->api_result_q);
@@ -914,6 +1726,16 @@ uint32_t yt_tui_init(yt_tui_t *tui, yt_conf_t *conf)
 
     yt_queue_init(&tui->queue);
 
+    if (conf->stream_cache_disk)
+    {
+        tui_sweep_task_ctx_t *sweep_ctx = (tui_sweep_task_ctx_t *)malloc(sizeof(tui_sweep_task_ctx_t));
+        if (sweep_ctx)
+        {
+            snprintf(sweep_ctx->cache_dir, sizeof(sweep_ctx->cache_dir), "%s", conf->cache_dir);
+            if (ldg_thread_pool_submit(&tui->pool, stream_sweep_task, sweep_ctx) != LDG_ERR_AOK) { free(sweep_ctx); }
+        }
+    }
+
     err = yt_token_load(&tui->token, conf->data_dir);
     if (err != LDG_ERR_AOK)
     {
@@ -976,38 +1798,45 @@ uint32_t yt_tui_run(yt_tui_t *tui)
         // feed
         if (tui->current_view == YT_TUI_VIEW_FEED && tui->feed.loading && !tui->feed_req_pending) { tui_feed_request(tui); }
 
-        // input
+        // input and mpv both wake the loop at once; the timeout only paces the pool result queues
+        struct pollfd pfds[2] = LDG_ARR_ZERO_INIT;
+        pfds[0].fd = notcurses_inputready_fd(tui->nc);
+        pfds[0].events = POLLIN;
+        pfds[1].fd = tui->player_ready ? (int)tui->player.wake_fd : -1;
+        pfds[1].events = POLLIN;
+        ppoll(pfds, 2, &ts, 0x0);
+
+        struct timespec nblock_ts = LDG_STRUCT_ZERO_INIT;
         struct ncinput ni = LDG_STRUCT_ZERO_INIT;
-        uint32_t got = notcurses_get(tui->nc, &ts, &ni);
+        uint32_t got = notcurses_get(tui->nc, &nblock_ts, &ni);
+
+        struct timespec loop_ts = LDG_STRUCT_ZERO_INIT;
+        clock_gettime(CLOCK_MONOTONIC, &loop_ts);
+        uint64_t loop_now = (uint64_t)loop_ts.tv_sec * LDG_NS_PER_SEC + (uint64_t)loop_ts.tv_nsec;
 
+        // a window drag fires a burst of these; the layout follows each one, the video only once it settles
         if (got != 0 && ni.id == NCKEY_RESIZE)
         {
-            if (tui->render_active)
-            {
-                yt_render_shutdown(&tui->render);
-                tui->render_active = 0;
-            }
-
             yt_feed_thumb_planes_destroy(&tui->feed);
             yt_layout_resize(&tui->layout, tui->nc);
 
-            if (tui->current_view == YT_TUI_VIEW_PLAYER && tui->player_ready)
-            {
-                unsigned content_rows = 0;
-                unsigned content_cols = 0;
-                ncplane_dim_yx(tui->layout.content, &content_rows, &content_cols);
-
-                uint32_t video_rows = (content_rows > YT_TUI_VIDEO_INFO_ROWS) ? content_rows - YT_TUI_VIDEO_INFO_ROWS : content_rows;
-                uint32_t video_cols = content_cols * 95 / 100;
+            tui->resize_pending = 1;
+            tui->resize_ns = loop_now;
 
-                yt_render_init(&tui->render, tui->player.mpv, tui->layout.content, video_rows, video_cols);
-                tui->render_active = 1;
-            }
+            tui_flush(tui);
 
-            notcurses_render(tui->nc);
             continue;
         }
 
+        if (tui->resize_pending && loop_now - tui->resize_ns >= YT_TUI_RESIZE_DEBOUNCE_NS)
+        {
+            tui->resize_pending = 0;
+            tui_player_resize(tui);
+        }
+
+        tui_stream_reselect(tui, loop_now);
+        tui_stream_speculate(tui, loop_now);
+
         if (got != 0)
         {
             if (tui->current_view == YT_TUI_VIEW_SEARCH)
@@ -1060,6 +1889,8 @@ uint32_t yt_tui_run(yt_tui_t *tui)
                         break;
                 }
             }
+
+            tui_video_visibility_sync(tui);
         }
 
         // poll auth result
@@ -1097,30 +1928,62 @@ uint32_t yt_tui_run(yt_tui_t *tui)
             while (ldg_spsc_pop(&tui->thumb_result_q, &thumb_result) == LDG_ERR_AOK) { yt_thumb_cache_put(&tui->feed.thumbs, thumb_result.video_id, thumb_result.vis); }
         }
 
-        // poll player events
+        // poll stream results; anything not for the end of the current window is stale
+        {
+            tui_stream_result_t stream_result;
+            if (ldg_spsc_pop(&tui->stream_result_q, &stream_result) == LDG_ERR_AOK)
+            {
+                tui->stream_req_pending = 0;
+                if (stream_result.gen == tui->stream_gen && stream_result.idx == tui->playlist_base + tui->playlist_len) { tui_stream_result_apply(tui, &stream_result); }
+
+                tui_stream_pump(tui);
+            }
+        }
+
+        // poll speculative resolves; they only fill the cache, a play waiting on one picks it up from there
+        {
+            tui_stream_result_t spec_result;
+            if (ldg_spsc_pop(&tui->spec_result_q, &spec_result) == LDG_ERR_AOK)
+            {
+                tui->spec_req_id[0] = '\0';
+                if (spec_result.err == LDG_ERR_AOK) { yt_stream_cache_put(&tui->stream_cache, spec_result.video_id, &spec_result.streams, (uint64_t)time(0x0)); }
+
+                tui_stream_pump(tui);
+            }
+        }
+
+        // player events; drained right here on the ui thread, nothing queues them in between
+        uint8_t player_dirty = 0;
         if (tui->player_ready)
         {
             yt_player_event_t pe = LDG_STRUCT_ZERO_INIT;
-            while (ldg_spsc_pop(&tui->player.event_q, &pe) == LDG_ERR_AOK)
+            while (yt_player_event_poll(&tui->player, &pe) == LDG_ERR_AOK)
             {
-                if (pe.eof_reached)
+                // pause, resume and track changes show up on the next draw, not the half-second refresh
+                if (pe.state_changed) { player_dirty = 1; }
+
+                // display aspect, sar applied; the renderer refits only when it actually moves
+                if (pe.aspect > 0.0)
                 {
-                    uint32_t next_ret = yt_queue_next(&tui->queue);
-                    if (next_ret == LDG_ERR_AOK)
-                    {
-                        const yt_video_t *vid = yt_queue_current_get(&tui->queue);
-                        if (vid) { tui_player_video_load(tui, vid->id); }
-                    }
-                    else
-                    {
-                        if (tui->render_active)
-                        {
-                            yt_render_shutdown(&tui->render);
-                            tui->render_active = 0;
-                        }
+                    tui->video_aspect = pe.aspect;
+                    if (tui->render_active) { yt_render_aspect_set(&tui->render, pe.aspect); }
+                }
 
-                        tui->current_view = YT_TUI_VIEW_FEED;
-                    }
+                // mpv walks its own playlist; the queue only follows where it landed
+                if (pe.playlist_moved && pe.playlist_pos >= 0 && (uint32_t)pe.playlist_pos < tui->playlist_len)
+                {
+                    uint32_t idx = tui->playlist_base + (uint32_t)pe.playlist_pos;
+                    if (idx < tui->queue.cunt) { tui->queue.current_idx = idx; }
+
+                    tui_stream_pump(tui);
+                }
+
+                // anything before the last item already rolled over to the prefetched next one
+                // an empty window is still resolving, so whatever just ended was the video it replaces
+                if (pe.eof_reached && (tui->playlist_base == UINT32_MAX || (tui->playlist_len > 0 && tui->queue.current_idx + 1 >= tui->queue.cunt)))
+                {
+                    tui_playback_stop(tui);
+                    tui->current_view = YT_TUI_VIEW_FEED;
                 }
             }
         }
@@ -1132,14 +1995,11 @@ uint32_t yt_tui_run(yt_tui_t *tui)
             clock_gettime(CLOCK_MONOTONIC, &nc_ts);
             uint64_t nc_now = (uint64_t)nc_ts.tv_sec * LDG_NS_PER_SEC + (uint64_t)nc_ts.tv_nsec;
 
-            if (got != 0 || nc_now - player_render_ns >= LDG_NS_PER_SEC / 2)
+            if (got != 0 || player_dirty || nc_now - player_render_ns >= LDG_NS_PER_SEC / 2)
             {
                 tui_player_render(tui);
 
-                if (tui->render_active) { yt_render_stdout_lock(&tui->render); }
-
-                notcurses_render(tui->nc);
-                if (tui->render_active) { yt_render_stdout_unlock(&tui->render); }
+                tui_flush(tui);
 
                 player_render_ns = nc_now;
             }
@@ -1171,7 +2031,7 @@ uint32_t yt_tui_run(yt_tui_t *tui)
                     break;
             }
 
-            notcurses_render(tui->nc);
+            tui_flush(tui);
         }
     }
 
@@ -1191,9 +2051,14 @@ void yt_tui_shutdown(yt_tui_t *tui)
 
     if (tui->player_ready) { yt_player_shutdown(&tui->player); }
 
+    // drains whatever is queued; notcurses_stop writes its own teardown after this
+    yt_output_shutdown(&tui->output);
+
     yt_feed_ctx_shutdown(&tui->feed);
     ldg_thread_pool_shutdown(&tui->pool);
+    yt_stream_cache_shutdown(&tui->stream_cache);
     ldg_spsc_shutdown(&tui->thumb_result_q);
+    ldg_spsc_shutdown(&tui->spec_result_q);
     ldg_spsc_shutdown(&tui->stream_result_q);
     ldg_spsc_shutdown(&tui->auth_result_q);
     ldg_spsc_shutdown(&tui->api_result_q);
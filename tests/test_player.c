@@ -1,8 +1,21 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <zlib.h>
 #include <dangling/core/err.h>
+#include <yeetee/core/err.h>
 #include <yeetee/player/player.h>
+#include <yeetee/player/frame.h>
+#include <yeetee/player/sixel.h>
+#include <yeetee/player/cells.h>
+#include <yeetee/player/hist.h>
+#include <yeetee/player/pages.h>
+#include <yeetee/player/stream.h>
+#include <yeetee/player/remote.h>
 
 static uint32_t tests_run = 0;
 static uint32_t tests_failed = 0;
@@ -33,10 +46,595 @@ static void test_player_init_null(void)
     TEST_ASSERT(ret == LDG_ERR_FUNC_ARG_NULL, "yt_player_init(NULL) should return FUNC_ARG_NULL");
 }
 
+static void test_player_event_poll(void)
+{
+    yt_player_t player;
+    memset(&player, 0, sizeof(player));
+
+    uint32_t ret = yt_player_init(&player);
+    TEST_ASSERT(ret == LDG_ERR_AOK, "yt_player_init failed");
+    TEST_ASSERT(player.wake_fd != UINT32_MAX, "wake fd should be open after init");
+
+    // nothing loaded; the queue drains to empty without blocking
+    yt_player_event_t pe;
+    ret = yt_player_event_poll(&player, &pe);
+    TEST_ASSERT(ret == LDG_ERR_EMPTY, "idle player should have no events");
+    TEST_ASSERT(yt_player_event_poll(&player, NULL) == LDG_ERR_FUNC_ARG_NULL, "NULL event should return FUNC_ARG_NULL");
+
+    yt_player_shutdown(&player);
+    TEST_ASSERT(player.wake_fd == UINT32_MAX, "wake fd should be closed after shutdown");
+}
+
+static void test_player_snap(void)
+{
+    yt_player_t player;
+    memset(&player, 0, sizeof(player));
+
+    uint32_t ret = yt_player_init(&player);
+    TEST_ASSERT(ret == LDG_ERR_AOK, "yt_player_init failed");
+
+    yt_player_snap_t snap;
+    ret = yt_player_snap_get(&player, &snap);
+    TEST_ASSERT(ret == LDG_ERR_AOK, "snap_get failed");
+    TEST_ASSERT(snap.state == YT_PLAYER_STOPPED, "fresh player should be stopped");
+    TEST_ASSERT(!snap.paused, "fresh player should not be paused");
+
+    // commands publish straight away; mpv confirms through the observed properties later
+    yt_player_volume_set(&player, 70);
+    yt_player_pause(&player);
+    yt_player_snap_get(&player, &snap);
+    TEST_ASSERT(snap.volume == 70, "volume should be published on set");
+    TEST_ASSERT(snap.paused, "pause should be published on set");
+    TEST_ASSERT((atomic_load(&player.snap_seq) & 1u) == 0, "seq should be even outside a write");
+
+    TEST_ASSERT(yt_player_snap_get(&player, NULL) == LDG_ERR_FUNC_ARG_NULL, "NULL snap should return FUNC_ARG_NULL");
+
+    yt_player_shutdown(&player);
+}
+
+static void test_player_playlist(void)
+{
+    yt_player_t player;
+    memset(&player, 0, sizeof(player));
+
+    uint32_t ret = yt_player_init(&player);
+    TEST_ASSERT(ret == LDG_ERR_AOK, "yt_player_init failed");
+
+    yt_player_snap_t snap;
+    yt_player_snap_get(&player, &snap);
+    TEST_ASSERT(snap.playlist_pos == -1, "fresh player should have no playing entry");
+    TEST_ASSERT(!snap.eof_reached, "fresh player should not be at eof");
+
+    double pos = -1.0;
+    TEST_ASSERT(yt_player_time_pos_get(&player, &pos) == LDG_ERR_AOK && pos == 0.0, "idle player should be at 0");
+    TEST_ASSERT(yt_player_time_pos_get(NULL, &pos) == LDG_ERR_FUNC_ARG_NULL, "NULL player time should return FUNC_ARG_NULL");
+
+    TEST_ASSERT(yt_player_append(&player, NULL) == LDG_ERR_FUNC_ARG_NULL, "NULL url should return FUNC_ARG_NULL");
+    TEST_ASSERT(yt_player_append(NULL, "x") == LDG_ERR_FUNC_ARG_NULL, "NULL player append should return FUNC_ARG_NULL");
+    TEST_ASSERT(yt_player_playlist_play(NULL, 0) == LDG_ERR_FUNC_ARG_NULL, "NULL player play should return FUNC_ARG_NULL");
+    TEST_ASSERT(yt_player_playlist_trim(NULL) == LDG_ERR_FUNC_ARG_NULL, "NULL player trim should return FUNC_ARG_NULL");
+
+    yt_player_shutdown(&player);
+    TEST_ASSERT(yt_player_append(&player, "x") == LDG_ERR_NOT_INIT, "append after shutdown should return NOT_INIT");
+}
+
+static void test_stream_pick(void)
+{
+    static yt_stream_set_t set;
+    memset(&set, 0, sizeof(set));
+
+    // muxed 360p avc, video only 720p avc / 1440p vp9 / 1080p vp9 / 1080p avc / 720p60 avc / 480p av1, two audio
+    const uint32_t heights[] = { 360, 720, 1440, 1080, 1080, 720, 480, 0, 0 };
+    const uint32_t fps[] = { 30, 30, 30, 30, 30, 60, 30, 0, 0 };
+    const uint32_t rates[] = { 500, 2000, 9000, 3000, 4000, 3500, 700, 128, 160 };
+    const char *mimes[] = { "video/mp4; codecs=\"avc1.42001E, mp4a.40.2\"", "video/mp4; codecs=\"avc1.4d401f\"", "video/webm; codecs=\"vp9\"", "video/webm; codecs=\"vp09.00.40.08\"", "video/mp4; codecs=\"avc1.640028\"", "video/mp4; codecs=\"avc1.4d4020\"", "video/mp4; codecs=\"av01.0.04M.08\"", "audio/mp4; codecs=\"mp4a.40.2\"", "audio/webm; codecs=\"opus\"" };
+    uint32_t i = 0;
+    for (; i < 9; i++)
+    {
+        snprintf(set.streams[i].url, YT_STREAM_URL_MAX, "https://host/%u", i);
+        snprintf(set.streams[i].mime, YT_STREAM_MIME_MAX, "%s", mimes[i]);
+        set.streams[i].height = heights[i];
+        set.streams[i].width = heights[i] * 16 / 9;
+        set.streams[i].fps = fps[i];
+        set.streams[i].bitrate = rates[i];
+        set.streams[i].is_audio = (heights[i] == 0);
+    }
+
+    set.streams[0].muxed = 1;
+    set.stream_cunt = 9;
+
+    TEST_ASSERT(yt_stream_codec_get(&set.streams[1]) == YT_STREAM_CODEC_AVC, "avc1 should parse as avc");
+    TEST_ASSERT(yt_stream_codec_get(&set.streams[3]) == YT_STREAM_CODEC_VP9, "vp09 should parse as vp9");
+    TEST_ASSERT(yt_stream_codec_get(&set.streams[6]) == YT_STREAM_CODEC_AV1, "av01 should parse as av1");
+
+    yt_stream_pick_t pick;
+    TEST_ASSERT(yt_stream_pick(&set, 1920, 1080, &pick) == LDG_ERR_AOK, "pick failed");
+    TEST_ASSERT(pick.video_idx == 4, "avc should win over vp9 at the same size");
+    TEST_ASSERT(pick.audio_idx == 8, "highest bitrate audio should win");
+
+    // a 1000x560 kitty surface; 720p30 avc covers it, 60 fps and vp9 cost more, 480p falls short
+    TEST_ASSERT(yt_stream_pick(&set, 1000, 560, &pick) == LDG_ERR_AOK, "small surface pick failed");
+    TEST_ASSERT(pick.video_idx == 1, "smallest covering avc stream should win");
+
+    // cells; nothing is smaller than the muxed stream, but separate audio still beats it
+    TEST_ASSERT(yt_stream_pick(&set, 120, 80, &pick) == LDG_ERR_AOK, "tiny surface pick failed");
+    TEST_ASSERT(pick.video_idx == 6, "cheapest covering video only stream should win");
+
+    TEST_ASSERT(yt_stream_pick(&set, 3840, 2160, &pick) == LDG_ERR_AOK, "huge surface pick failed");
+    TEST_ASSERT(pick.video_idx == 2, "nothing covers, so the largest should win");
+
+    // shrinking to half the cost is worth a reload, a stream that still covers and costs about the same is not
+    yt_stream_pick_t cur = { 4, 8 };
+    yt_stream_pick_t next = { 1, 8 };
+    TEST_ASSERT(yt_stream_switch_worth(&set, &cur, &next, 1000, 560), "1080p to 720p should be worth a switch");
+    TEST_ASSERT(!yt_stream_switch_worth(&set, &next, &cur, 1000, 560), "720p to 1080p should not be worth a switch when 720p covers");
+    TEST_ASSERT(yt_stream_switch_worth(&set, &next, &cur, 1920, 1080), "720p to 1080p should be worth a switch once 720p stops covering");
+
+    char url[YT_STREAM_EDL_MAX];
+    TEST_ASSERT(yt_stream_pick_audio(&set, &pick) == LDG_ERR_AOK, "audio pick failed");
+    TEST_ASSERT(pick.video_idx == UINT32_MAX && pick.audio_idx == 8, "audio pick should carry no video");
+    TEST_ASSERT(yt_stream_url_build(&set, &pick, url, sizeof(url)) == LDG_ERR_AOK, "audio url build failed");
+    TEST_ASSERT(strcmp(url, "edl://!no_clip;!no_chapters;%14%https://host/8") == 0, "audio url should be a one part edl");
+
+    // no audio only streams; the muxed one carries sound
+    set.stream_cunt = 7;
+    TEST_ASSERT(yt_stream_pick(&set, 1920, 1080, &pick) == LDG_ERR_AOK, "muxed pick failed");
+    TEST_ASSERT(pick.video_idx == 0 && pick.audio_idx == UINT32_MAX, "muxed should beat silent video");
+    TEST_ASSERT(yt_stream_pick_audio(&set, &pick) == LDG_ERR_AOK && pick.video_idx == 0, "audio pick should fall back to muxed");
+
+    set.stream_cunt = 0;
+    TEST_ASSERT(yt_stream_pick(&set, 1920, 1080, &pick) == YT_ERR_PLAYER_NO_STREAM, "empty set should have no stream");
+    TEST_ASSERT(yt_stream_pick(NULL, 1920, 1080, &pick) == LDG_ERR_FUNC_ARG_NULL, "NULL set should return FUNC_ARG_NULL");
+}
+
+static void test_stream_edl(void)
+{
+    char out[YT_STREAM_EDL_MAX];
+
+    TEST_ASSERT(yt_stream_edl_build("https://v/a;b", "https://a/c", out, sizeof(out)) == LDG_ERR_AOK, "edl build failed");
+    TEST_ASSERT(strcmp(out, "edl://!no_clip;!no_chapters;%13%https://v/a;b;!new_stream;!no_clip;!no_chapters;%11%https://a/c") == 0, "edl layout mismatch");
+
+    TEST_ASSERT(yt_stream_edl_build("https://v/a", NULL, out, sizeof(out)) == LDG_ERR_AOK, "single edl build failed");
+    TEST_ASSERT(strcmp(out, "edl://!no_clip;!no_chapters;%11%https://v/a") == 0, "single edl layout mismatch");
+
+    TEST_ASSERT(yt_stream_edl_build("https://v/a", "https://a/c", out, 16) == LDG_ERR_STR_TRUNC, "short buffer should truncate");
+    TEST_ASSERT(yt_stream_edl_build(NULL, NULL, out, sizeof(out)) == LDG_ERR_FUNC_ARG_NULL, "NULL url should return FUNC_ARG_NULL");
+}
+
+static void test_stream_cache(void)
+{
+    static yt_stream_set_t set;
+    memset(&set, 0, sizeof(set));
+    snprintf(set.streams[0].url, YT_STREAM_URL_MAX, "https://r1.googlevideo.com/videoplayback?expire=1700020000&ei=x&itag=137");
+    snprintf(set.streams[1].url, YT_STREAM_URL_MAX, "https://r1.googlevideo.com/videoplayback?noexpire=5&expire=1700010000&itag=140");
+    set.streams[1].is_audio = 1;
+    set.stream_cunt = 2;
+
+    TEST_ASSERT(yt_stream_expire_get(&set) == 1700010000, "set should expire with its first url");
+
+    yt_stream_cache_t cache;
+    TEST_ASSERT(yt_stream_cache_init(&cache, 2) == LDG_ERR_AOK, "cache init failed");
+
+    uint64_t now = 1700000000;
+    TEST_ASSERT(yt_stream_cache_put(&cache, "aaa", &set, now) == LDG_ERR_AOK, "put failed");
+    TEST_ASSERT(yt_stream_cache_get(&cache, "aaa", now) != NULL, "fresh entry should hit");
+    TEST_ASSERT(yt_stream_cache_get(&cache, "bbb", now) == NULL, "unknown id should miss");
+    TEST_ASSERT(yt_stream_cache_get(&cache, "aaa", 1700010000 - YT_STREAM_EXPIRE_MARGIN_SECS) == NULL, "entry inside the margin should miss");
+    TEST_ASSERT(yt_stream_cache_get(&cache, "aaa", now) == NULL, "expired entry should have been dropped");
+
+    // aaa is used after bbb, so ccc takes bbb's place
+    yt_stream_cache_put(&cache, "aaa", &set, now);
+    yt_stream_cache_put(&cache, "bbb", &set, now);
+    yt_stream_cache_get(&cache, "aaa", now);
+    TEST_ASSERT(yt_stream_cache_put(&cache, "ccc", &set, now) == LDG_ERR_AOK, "put over capacity failed");
+    TEST_ASSERT(yt_stream_cache_get(&cache, "bbb", now) == NULL, "least recently used should be evicted");
+    TEST_ASSERT(yt_stream_cache_get(&cache, "aaa", now) != NULL && yt_stream_cache_get(&cache, "ccc", now) != NULL, "recent entries should stay");
+
+    char dir[] = "/tmp/yt_test_sc_XXXXXX";
+    TEST_ASSERT(mkdtemp(dir) != NULL, "mkdtemp failed");
+    TEST_ASSERT(yt_stream_cache_file_save(dir, "sc", &set) == LDG_ERR_AOK, "file save failed");
+    static yt_stream_set_t loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    TEST_ASSERT(yt_stream_cache_file_load(dir, "sc", &loaded, now) == LDG_ERR_AOK, "file load failed");
+    TEST_ASSERT(loaded.stream_cunt == 2 && strcmp(loaded.streams[1].url, set.streams[1].url) == 0, "file round trip mismatch");
+    TEST_ASSERT(yt_stream_cache_file_load(dir, "sc", &loaded, 1700010000) == YT_ERR_PLAYER_STREAM_EXPIRED, "stale file should expire");
+    TEST_ASSERT(yt_stream_cache_file_load(dir, "sc", &loaded, now) == LDG_ERR_IO_OPEN, "stale file should have been removed");
+
+    // files never read back are reaped by the sweep once they expire
+    yt_stream_cache_file_save(dir, "sc", &set);
+    TEST_ASSERT(yt_stream_cache_file_sweep(dir, now) == 0, "fresh file should survive the sweep");
+    TEST_ASSERT(yt_stream_cache_file_sweep(dir, 1700010000) == 1, "expired file should be swept");
+    TEST_ASSERT(rmdir(dir) == 0, "sweep should leave the dir empty");
+
+    // no expire= anywhere, nothing to go by
+    snprintf(set.streams[1].url, YT_STREAM_URL_MAX, "https://host/audio");
+    TEST_ASSERT(yt_stream_expire_get(&set) == 0, "url without expire should make the set uncacheable");
+    TEST_ASSERT(yt_stream_cache_put(&cache, "ddd", &set, now) == YT_ERR_PLAYER_STREAM_EXPIRED, "uncacheable set should be refused");
+
+    yt_stream_cache_shutdown(&cache);
+}
+
+static void test_frame_fmt(void)
+{
+    TEST_ASSERT(yt_frame_fmt_bpp_get(YT_FRAME_FMT_RGB24) == 3, "rgb24 should be 3 bpp");
+    TEST_ASSERT(yt_frame_fmt_bpp_get(YT_FRAME_FMT_RGBA32) == 4, "rgba32 should be 4 bpp");
+    TEST_ASSERT(yt_frame_fmt_kitty_get(YT_FRAME_FMT_RGB24) == 24, "rgb24 should map to kitty f=24");
+    TEST_ASSERT(yt_frame_fmt_kitty_get(YT_FRAME_FMT_RGBA32) == 32, "rgba32 should map to kitty f=32");
+    TEST_ASSERT(strcmp(yt_frame_fmt_mpv_get(YT_FRAME_FMT_RGB24), "rgb24") == 0, "rgb24 mpv format mismatch");
+    TEST_ASSERT(strcmp(yt_frame_fmt_mpv_get(YT_FRAME_FMT_RGBA32), "rgb0") == 0, "rgba32 mpv format mismatch");
+}
+
+static void test_frame_alpha_kernels(void)
+{
+    yt_frame_alpha_kernel_t kernels[YT_FRAME_ALPHA_KERNEL_MAX];
+    uint32_t cunt = yt_frame_alpha_kernels_get(kernels, YT_FRAME_ALPHA_KERNEL_MAX);
+    TEST_ASSERT(cunt >= 1, "at least the scalar kernel should be available");
+
+    // odd pixel cunt and unaligned start exercise the vector tails
+    uint8_t buff[4 * 301 + 1];
+    uint32_t k = 0;
+    for (; k < cunt; k++)
+    {
+        uint8_t *px = buff + 1;
+        size_t i = 0;
+        for (; i < 4 * 301; i++) { px[i] = (uint8_t)(i * 7); }
+
+        kernels[k].fn(px, 4 * 301);
+
+        uint8_t ok = 1;
+        for (i = 0; i < 4 * 301; i++)
+        {
+            uint8_t want = ((i & 3) == 3) ? 0xFF : (uint8_t)(i * 7);
+            if (px[i] != want) { ok = 0; }
+        }
+
+        TEST_ASSERT(ok, kernels[k].name);
+    }
+}
+
+static void test_frame_b64(void)
+{
+    char out[32] = { 0 };
+    size_t len = yt_frame_b64_encode((const uint8_t *)"/dev/shm/a", 10, out, sizeof(out));
+    TEST_ASSERT(len == 16, "b64 length mismatch");
+    TEST_ASSERT(strcmp(out, "L2Rldi9zaG0vYQ==") == 0, "b64 output mismatch");
+
+    len = yt_frame_b64_encode((const uint8_t *)"abc", 3, out, 4);
+    TEST_ASSERT(len == 0, "b64 should refuse a dst without room for the terminator");
+}
+
+static void test_frame_b64_kernels(void)
+{
+    yt_frame_b64_kernel_t kernels[YT_FRAME_B64_KERNEL_MAX];
+    uint32_t cunt = yt_frame_b64_kernels_get(kernels, YT_FRAME_B64_KERNEL_MAX);
+    TEST_ASSERT(cunt >= 1, "at least the scalar kernel should be available");
+
+    uint8_t src[203];
+    size_t i = 0;
+    for (; i < sizeof(src); i++) { src[i] = (uint8_t)(i * 151 + 7); }
+
+    // every length hits a different split between the vector body and the scalar tail
+    char want[YT_FRAME_B64_LEN(sizeof(src))];
+    char got[YT_FRAME_B64_LEN(sizeof(src))];
+    uint32_t k = 1;
+    for (; k < cunt; k++)
+    {
+        uint8_t ok = 1;
+        size_t len = 0;
+        for (; len <= sizeof(src); len++)
+        {
+            size_t want_len = kernels[0].fn(src, len, want);
+            size_t got_len = kernels[k].fn(src, len, got);
+            if (got_len != want_len || memcmp(want, got, want_len) != 0) { ok = 0; }
+        }
+
+        TEST_ASSERT(ok, kernels[k].name);
+    }
+}
+
+static void test_frame_quant_kernels(void)
+{
+    yt_frame_quant_kernel_t kernels[YT_FRAME_QUANT_KERNEL_MAX];
+    uint32_t cunt = yt_frame_quant_kernels_get(kernels, YT_FRAME_QUANT_KERNEL_MAX);
+    TEST_ASSERT(cunt >= 2, "scalar and generic kernels should be available");
+
+    // odd width so the vector body leaves a tail; bright values exercise the saturating add
+    enum { W = 37, H = 9, STRIDE = W * 4 + 12 };
+    uint8_t src[STRIDE * H];
+    size_t i = 0;
+    for (; i < sizeof(src); i++) { src[i] = (uint8_t)(i * 97 + 200); }
+
+    uint8_t want[W * H];
+    uint8_t got[W * H];
+    kernels[0].fn(src, W, H, STRIDE, 3, want);
+
+    uint32_t k = 1;
+    for (; k < cunt; k++)
+    {
+        memset(got, 0, sizeof(got));
+        kernels[k].fn(src, W, H, STRIDE, 3, got);
+        TEST_ASSERT(memcmp(want, got, sizeof(want)) == 0, kernels[k].name);
+    }
+
+    uint8_t white[16] = { 255, 255, 255, 0, 255, 255, 255, 0, 255, 255, 255, 0, 255, 255, 255, 0 };
+    uint8_t idx[4];
+    yt_frame_quant(white, 4, 1, sizeof(white), 0, idx);
+    TEST_ASSERT(idx[0] == 0xFF && idx[3] == 0xFF, "white should map to the last palette entry");
+}
+
+static void test_sixel_encode(void)
+{
+    // 8x7 black: two bands, the second one row high
+    uint8_t px[8 * 7 * 4];
+    memset(px, 0, sizeof(px));
+
+    yt_sixel_t sixel;
+    memset(&sixel, 0, sizeof(sixel));
+    uint32_t err = yt_sixel_encode(&sixel, px, 8, 8 * 4, 0, 7);
+    TEST_ASSERT(err == LDG_ERR_AOK, "encode should succeed");
+    TEST_ASSERT(sixel.out_len > 0 && memcmp(sixel.out, "\x1bP0;1;0q\"1;1;8;7", 16) == 0, "should open with dcs and raster attributes");
+    TEST_ASSERT(memcmp(sixel.out + sixel.out_len - 2, "\x1b\\", 2) == 0, "should end with st");
+    TEST_ASSERT(memmem(sixel.out, sixel.out_len, "#0!8~-#0!8@$", 12) != 0x0, "full band then one-row band should be run length coded");
+
+    err = yt_sixel_encode(&sixel, px, 0, 0, 0, 7);
+    TEST_ASSERT(err == LDG_ERR_FUNC_ARG_INVALID, "zero width should fail");
+
+    yt_sixel_free(&sixel);
+}
+
+static void test_cells_encode(void)
+{
+    uint8_t px[6 * 4 * 4];
+    memset(px, 0x40, sizeof(px));
+
+    yt_cells_t cells;
+    memset(&cells, 0, sizeof(cells));
+    uint32_t err = yt_cells_encode(&cells, px, 6, 4, 6 * 4, 0, 2, 0, 0);
+    TEST_ASSERT(err == LDG_ERR_AOK && cells.emit_cunt == 12, "first frame should draw every cell");
+
+    err = yt_cells_encode(&cells, px, 6, 4, 6 * 4, 0, 2, 0, 0);
+    TEST_ASSERT(err == LDG_ERR_AOK && cells.out_len == 0, "identical frame should emit nothing");
+
+    // below the 15-bit reduction; noise never repaints
+    px[0] = 0x41;
+    err = yt_cells_encode(&cells, px, 6, 4, 6 * 4, 0, 2, 0, 0);
+    TEST_ASSERT(err == LDG_ERR_AOK && cells.out_len == 0, "sub-threshold change should emit nothing");
+
+    px[(2 * 6 + 5) * 4] = 0xFF;
+    err = yt_cells_encode(&cells, px, 6, 4, 6 * 4, 0, 2, 0, 0);
+    TEST_ASSERT(err == LDG_ERR_AOK && cells.emit_cunt == 1, "one changed pixel should redraw one cell");
+    TEST_ASSERT(cells.out_len > 0 && memmem(cells.out, cells.out_len, "\x1b[2;6H", 6) != 0x0, "changed cell should be addressed directly");
+
+    yt_cells_free(&cells);
+}
+
+static void test_frame_tiles_hash(void)
+{
+    // 130x70 rgb24 with pudding in the stride: 3x2 tiles, the right and bottom ones partial
+    uint32_t w = 130;
+    uint32_t h = 70;
+    size_t stride = (size_t)w * 3 + 6;
+    uint8_t *buff = (uint8_t *)calloc(stride * h, 1);
+    TEST_ASSERT(buff != NULL, "calloc failed");
+    if (!buff) { return; }
+
+    size_t i = 0;
+    for (; i < stride * h; i++) { buff[i] = (uint8_t)(i * 13); }
+
+    uint64_t a[8];
+    uint64_t b[8];
+    uint32_t cunt = yt_frame_tiles_hash(buff, w, h, stride, 3, a, 8);
+    TEST_ASSERT(cunt == 6, "tile cunt mismatch");
+    TEST_ASSERT(yt_frame_tiles_hash(buff, w, h, stride, 3, a, 4) == 0, "undersized out should be refused");
+
+    yt_frame_tiles_hash(buff, w, h, stride, 3, b, 8);
+    TEST_ASSERT(memcmp(a, b, 6 * sizeof(uint64_t)) == 0, "identical frames should hash identically");
+
+    // last pixel of the frame and a byte in the pudding
+    buff[69 * stride + 129 * 3 + 2] ^= 0x80;
+    buff[10 * stride + (size_t)w * 3] ^= 0xFF;
+    yt_frame_tiles_hash(buff, w, h, stride, 3, b, 8);
+
+    uint32_t changed = 0;
+    uint32_t t = 0;
+    for (; t < 6; t++) { changed += (a[t] != b[t]); }
+
+    TEST_ASSERT(changed == 1 && a[5] != b[5], "only the bottom right tile should change");
+
+    // the changed tile collapses to its full-width row band, clipped to the frame
+    uint32_t rows = 0;
+    TEST_ASSERT(yt_frame_tiles_band(a, b, 6, w, h, &rows) == 64 && rows == 6, "band should be the bottom tile row");
+    TEST_ASSERT(yt_frame_tiles_band(a, a, 6, w, h, &rows) == YT_FRAME_BAND_NONE && rows == 0, "identical hashes should leave no band");
+
+    char esc[256];
+    int esc_len = yt_frame_kitty_band_esc(esc, sizeof(esc), YT_FRAME_FMT_RGB24, w, stride, 64, 6, 9, "bmFtZQ==");
+    TEST_ASSERT(esc_len > 0 && strcmp(esc, "\x1b_Ga=f,r=1,X=1,q=2,f=24,x=0,y=64,s=130,v=6,O=25344,S=2376,i=9,t=s;bmFtZQ==\x1b\\") == 0, "band escape mismatch");
+
+    free(buff);
+}
+
+static size_t test_b64_decode(const char *src, size_t len, uint8_t *dst)
+{
+    static const char tab[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t acc = 0;
+    uint32_t bits = 0;
+    size_t n = 0;
+    size_t i = 0;
+    for (; i < len && src[i] != '='; i++)
+    {
+        const char *hit = strchr(tab, src[i]);
+        if (!hit) { return 0; }
+
+        acc = (acc << 6) | (uint32_t)(hit - tab);
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            dst[n++] = (uint8_t)(acc >> bits);
+        }
+    }
+
+    return n;
+}
+
+static void test_remote_chunks(void)
+{
+    // 256x64 rgb24 noise so the dirty band still needs several chunks after compression
+    uint32_t w = 256;
+    uint32_t h = 64;
+    size_t stride = (size_t)w * 3;
+    uint8_t *pixels = (uint8_t *)malloc(stride * h);
+    uint8_t *b64 = (uint8_t *)malloc(stride * h * 2);
+    uint8_t *z = (uint8_t *)malloc(stride * h * 2);
+    uint8_t *raw = (uint8_t *)malloc(stride * h);
+    TEST_ASSERT(pixels && b64 && z && raw, "malloc failed");
+    if (!pixels || !b64 || !z || !raw) { free(pixels); free(b64); free(z); free(raw); return; }
+
+    uint32_t x = 0x9E3779B9u;
+    size_t i = 0;
+    for (; i < stride * h; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        pixels[i] = (uint8_t)x;
+    }
+
+    static yt_remote_t remote;
+    memset(&remote, 0, sizeof(remote));
+    remote.shown_id = 7;
+
+    yt_remote_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.pixels = pixels;
+    job.stride = stride;
+    job.fmt = YT_FRAME_FMT_RGB24;
+    job.kitty_id = 8;
+    job.pixel_w = w;
+    job.pixel_h = h;
+    job.dirty_y = 16;
+    job.dirty_rows = 32;
+    job.delta = 1;
+
+    size_t len = yt_remote_job_encode(&remote, &job);
+    TEST_ASSERT(len > 0, "delta encode failed");
+
+    // walk the apcs: keys up to ';', payload up to ST
+    const char *out = remote.out_buff;
+    size_t o = 0;
+    size_t b64_len = 0;
+    uint32_t chunks = 0;
+    uint32_t bad_keys = 0;
+    uint32_t last_more = 1;
+    while (o + 3 <= len && memcmp(out + o, "\x1b_G", 3) == 0)
+    {
+        const char *keys = out + o + 3;
+        const char *semi = memchr(keys, ';', len - o - 3);
+        if (!semi) { break; }
+
+        const char *st = memmem(semi, len - (size_t)(semi - out), "\x1b\\", 2);
+        if (!st) { break; }
+
+        size_t keys_len = (size_t)(semi - keys);
+        if (chunks == 0) { bad_keys += (keys_len < 4 || memcmp(keys, "a=f,", 4) != 0 || !memmem(keys, keys_len, "q=2", 3) || !memmem(keys, keys_len, "y=16,", 5) || !memmem(keys, keys_len, "v=32,", 5) || !memmem(keys, keys_len, "i=7,", 4)); }
+        else { bad_keys += (keys_len != 11 || memcmp(keys, "a=f,q=2,m=", 10) != 0); }
+
+        last_more = (uint32_t)(keys[keys_len - 1] - '0');
+        memcpy(b64 + b64_len, semi + 1, (size_t)(st - semi - 1));
+        b64_len += (size_t)(st - semi - 1);
+        o = (size_t)(st - out) + 2;
+        chunks++;
+    }
+
+    TEST_ASSERT(o == len, "delta should be nothing but apcs");
+    TEST_ASSERT(chunks > 2, "band should need several chunks");
+    TEST_ASSERT(bad_keys == 0, "every delta chunk should carry a=f and q=2");
+    TEST_ASSERT(last_more == 0, "last chunk should close the transfer");
+
+    size_t z_len = test_b64_decode((const char *)b64, b64_len, z);
+    uLongf raw_len = (uLongf)(stride * h);
+    TEST_ASSERT(uncompress(raw, &raw_len, z, (uLong)z_len) == Z_OK, "payload should inflate");
+    TEST_ASSERT(raw_len == 32 * stride && memcmp(raw, pixels + 16 * stride, raw_len) == 0, "payload should be the dirty band");
+
+    // whole frames keep q=2 on continuations but not a=f
+    job.delta = 0;
+    len = yt_remote_job_encode(&remote, &job);
+    TEST_ASSERT(len > 0, "whole encode failed");
+    TEST_ASSERT(memmem(remote.out_buff, len, "\x1b_Gq=2,m=1;", 11) != NULL, "whole continuation should carry q=2");
+    TEST_ASSERT(memmem(remote.out_buff, len, "\x1b_Ga=f,q=2", 10) == NULL, "whole frame should not carry a=f");
+
+    yt_remote_shutdown(&remote);
+    free(pixels);
+    free(b64);
+    free(z);
+    free(raw);
+}
+
+static void test_hist_pct(void)
+{
+    yt_hist_t *hist = (yt_hist_t *)malloc(sizeof(*hist));
+    TEST_ASSERT(hist != NULL, "malloc failed");
+    if (!hist) { return; }
+
+    yt_hist_reset(hist);
+    TEST_ASSERT(yt_hist_pct(hist, 500) == 0, "empty histogram should read zero");
+
+    // 1..1000 us plus one 50 ms outlier
+    uint64_t v = 1;
+    for (; v <= 1000; v++) { yt_hist_record(hist, v * 1000); }
+
+    yt_hist_record(hist, 50000000);
+
+    uint64_t p50 = yt_hist_pct(hist, 500);
+    uint64_t p99 = yt_hist_pct(hist, 990);
+    TEST_ASSERT(hist->cunt == 1001, "cunt mismatch");
+    TEST_ASSERT(p50 >= 500000 && p50 <= 500000 + 500000 / 16, "p50 outside bucket precision");
+    TEST_ASSERT(p99 >= 990000 && p99 <= 990000 + 990000 / 16, "p99 outside bucket precision");
+    TEST_ASSERT(yt_hist_pct(hist, 1000) == 50000000 && hist->max == 50000000, "max should be exact");
+
+    // small values land in exact buckets, huge ones clamp to the last
+    yt_hist_reset(hist);
+    yt_hist_record(hist, 7);
+    TEST_ASSERT(yt_hist_pct(hist, 500) == 7, "small values should be exact");
+
+    yt_hist_record(hist, UINT64_MAX);
+    TEST_ASSERT(hist->buckets[YT_HIST_BUCKETS - 1] == 1, "overflow should clamp to the last bucket");
+
+    free(hist);
+}
+
+static void test_pages_align(void)
+{
+    TEST_ASSERT(yt_pages_stride_align(1366 * 4) == 5504, "stride should pad to a cache line");
+    TEST_ASSERT(yt_pages_stride_align(1920 * 4) == 1920 * 4, "aligned stride should be unchanged");
+    TEST_ASSERT(yt_pages_huge_round(1920 * 1080 * 4) == YT_PAGES_HUGE_SIZE * 4, "1080p rgba should round to four huge pages");
+    TEST_ASSERT(yt_pages_huge_round(YT_PAGES_HUGE_SIZE) == YT_PAGES_HUGE_SIZE, "exact multiple should be unchanged");
+
+    uint32_t fd = 0;
+    TEST_ASSERT(yt_pages_hugetlb_open(4096, &fd) == LDG_ERR_FUNC_ARG_INVALID, "hugetlb size must be a huge page multiple");
+}
+
 int main(void)
 {
     TEST_RUN(test_player_init_shutdown);
     TEST_RUN(test_player_init_null);
+    TEST_RUN(test_player_event_poll);
+    TEST_RUN(test_player_snap);
+    TEST_RUN(test_player_playlist);
+    TEST_RUN(test_stream_pick);
+    TEST_RUN(test_stream_edl);
+    TEST_RUN(test_stream_cache);
+    TEST_RUN(test_frame_fmt);
+    TEST_RUN(test_frame_alpha_kernels);
+    TEST_RUN(test_frame_b64);
+    TEST_RUN(test_frame_b64_kernels);
+    TEST_RUN(test_frame_quant_kernels);
+    TEST_RUN(test_sixel_encode);
+    TEST_RUN(test_cells_encode);
+    TEST_RUN(test_frame_tiles_hash);
+    TEST_RUN(test_remote_chunks);
+    TEST_RUN(test_hist_pct);
+    TEST_RUN(test_pages_align);
 
     fprintf(stderr, "player: %u/%u passed\n", tests_run - tests_failed, tests_run);
     return tests_failed > 0 ? 1 : 0;
@@ -65,6 +65,24 @@ static void test_input_unknown(void)
     TEST_ASSERT(action == YT_ACTION_NONE, "unknown key should map to NONE");
 }
 
+static void test_input_stats(void)
+{
+    struct ncinput ni;
+    memset(&ni, 0, sizeof(ni));
+    ni.id = 'i';
+
+    TEST_ASSERT(yt_input_dispatch(&ni) == YT_ACTION_STATS, "i should map to STATS");
+
+    ni.id = 'v';
+    TEST_ASSERT(yt_input_dispatch(&ni) == YT_ACTION_PLAYER, "v should map to PLAYER");
+
+    ni.id = 'x';
+    TEST_ASSERT(yt_input_dispatch(&ni) == YT_ACTION_STOP, "x should map to STOP");
+
+    ni.id = 'o';
+    TEST_ASSERT(yt_input_dispatch(&ni) == YT_ACTION_AUDIO, "o should map to AUDIO");
+}
+
 static void test_queue_push_pop(void)
 {
     yt_queue_t q;
@@ -132,6 +150,30 @@ static void test_queue_clear(void)
     TEST_ASSERT(cur == NULL, "current should be NULL after clear");
 }
 
+static void test_queue_shuffle(void)
+{
+    yt_queue_t q;
+    yt_queue_init(&q);
+
+    yt_video_t v;
+    memset(&v, 0, sizeof(v));
+
+    uint32_t i = 0;
+    for (; i < 32; i++)
+    {
+        snprintf(v.id, YT_VIDEO_ID_MAX, "vid%u", i);
+        yt_queue_push(&q, &v);
+    }
+
+    q.current_idx = 7;
+    TEST_ASSERT(yt_queue_shuffle(&q) == LDG_ERR_AOK, "shuffle failed");
+    TEST_ASSERT(q.cunt == 32, "shuffle should keep the cunt");
+
+    const yt_video_t *cur = yt_queue_current_get(&q);
+    TEST_ASSERT(cur != NULL, "current should survive a shuffle");
+    TEST_ASSERT(strcmp(cur->id, "vid7") == 0, "current should follow the playing video");
+}
+
 static void test_queue_full(void)
 {
     yt_queue_t q;
@@ -160,8 +202,10 @@ int main(void)
     TEST_RUN(test_input_nav);
     TEST_RUN(test_input_select);
     TEST_RUN(test_input_unknown);
+    TEST_RUN(test_input_stats);
     TEST_RUN(test_queue_push_pop);
     TEST_RUN(test_queue_clear);
+    TEST_RUN(test_queue_shuffle);
     TEST_RUN(test_queue_full);
 
     fprintf(stderr, "tui: %u/%u passed\n", tests_run - tests_failed, tests_run);